@@ -0,0 +1,113 @@
+/* standard includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <ctype.h>
+#include <string>
+#include <chrono>
+
+#include "rubikscube/scramblecorpus.h"
+#include "rubikscube/scrambler.h"
+
+using namespace std;
+
+/**********************************************************************
+** corpusgen -- writes a corpus of scrambled states for test runs    **
+**                                                                   **
+** usage: corpusgen [-n count] [-k seed] [-l length] [-u] file       **
+**        corpusgen -v file                                          **
+**   -n  states in the corpus (default: 1000000)                     **
+**   -k  seed of the scrambler (default: 1)                          **
+**   -l  face moves per scramble (default: 25)                       **
+**   -u  uniform random states instead of random moves               **
+**   -v  only check the checksum of the corpus and show its header   **
+**********************************************************************/
+
+static void usage() {
+    fprintf(stderr, "usage: corpusgen [-n count] [-k seed] [-l length] [-u] file\n");
+    fprintf(stderr, "       corpusgen -v file\n");
+    exit(EXIT_FAILURE);
+}
+
+// a count or seed, strtoull would take "-1" as 2^64-1 and "abc" as 0
+static uint64_t parseNumber(const char* text) {
+    unsigned long long value;
+    char* end;
+
+    while (isspace((unsigned char) *text))
+        text++;
+    if (*text == '-')
+        usage();
+    errno = 0;
+    value = strtoull(text, &end, 0);
+    if (end == text || *end != 0 || errno == ERANGE)
+        usage();
+    return value;
+}
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static bool verifyCorpus(const string& path) {
+    ScrambleCorpus corpus;
+    bool ok;
+
+    if (!corpus.load(path))
+        return false;
+    ok = corpus.verify();
+    printf("%s: %llu states, seed %llu, streams from %llu, %s, scrambler version %u, %s\n", path.c_str(),
+           (unsigned long long) corpus.getCount(), (unsigned long long) corpus.getSeed(),
+           (unsigned long long) corpus.getFirstStream(),
+           corpus.getMode() == SCRAMBLE_RANDOM_STATE ? "random states" : "random moves",
+           corpus.getGeneratorVersion(), ok ? "ok" : "damaged");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    string path;
+    uint64_t count = 1000000;
+    uint64_t seed = 1;
+    unsigned length = SCRAMBLE_LENGTH;
+    ScrambleMode mode = SCRAMBLE_MOVES;
+    bool verifyOnly = false;
+    char* end;
+    long value;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            count = parseNumber(argv[++i]);
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc)
+            seed = parseNumber(argv[++i]);
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            // a negative length would wrap around to billions of moves
+            value = strtol(argv[++i], &end, 0);
+            if (end == argv[i] || *end != 0 || value < 0 || (unsigned long) value > UINT_MAX)
+                usage();
+            length = value;
+        }
+        else if (strcmp(argv[i], "-u") == 0)
+            mode = SCRAMBLE_RANDOM_STATE;
+        else if (strcmp(argv[i], "-v") == 0)
+            verifyOnly = true;
+        else if (argv[i][0] == '-' || !path.empty())
+            usage();
+        else
+            path = argv[i];
+    }
+    if (path.empty())
+        usage();
+
+    if (verifyOnly)
+        return verifyCorpus(path) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if (!writeScrambleCorpus(path, seed, mode, length, count))
+        exit(EXIT_FAILURE);
+    printf("%llu states written in %.1f s\n", (unsigned long long) count, secondsSince(start));
+
+    return verifyCorpus(path) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,9 +1,12 @@
 /* standard includes */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <array>
 #include <vector>
 #include <iostream>
+#include <chrono>
 #include <glm/gtx/string_cast.hpp>
 
 /* We use glew.h instead of gl.h to get all the GL prototypes declared */
@@ -20,6 +23,15 @@
 #include "rubikscube/cube.h"
 #include "rubikscube/rubikscube.h"
 #include "rubikscube/texCube.h"
+#include "rubikscube/backgroundsolver.h"
+#include "rubikscube/scrambletask.h"
+#include "rubikscube/scrambler.h"
+#include "rubikscube/movetable.h"
+#include "rubikscube/offscreen.h"
+#include "rubikscube/framewriter.h"
+#include "rubikscube/framecapture.h"
+#include "rubikscube/animationclock.h"
+#include "rubikscube/notation.h"
 
 #define GLSL(src) "#version 330 core\n" #src
 #define GLM_FORCE_RADIANS
@@ -37,452 +49,70 @@ int TOP_RIGHT = 6;
 int BOTTOM_LEFT = 7;
 int BOTTOM_RIGHT = 8;
 
-const int AXIS_UP = 1;
-const int AXIS_DOWN = -1;
-const int AXIS_LEFT = 2;
-const int AXIS_RIGHT = -2;
-const int AXIS_FRONT = 3;
-const int AXIS_BACK = -3;
+// all turns go around an axis through the center of the cube
+const glm::vec3 CUBE_CENTER = glm::vec3(0.0f, 0.0f, -2.1f);
 
-const int UP_X = 1;
-const int DOWN_X = -1;
-const int LEFT_Y = 2;
-const int RIGHT_Y = -2;
-const int LEFT_Z = 3;
-const int RIGHT_Z = -3;
+// the 4 corners of each face of the cubie mesh, instances: 27 cubies and the body
+const int CUBIE_VERTICES = 24;
+const int NR_CUBIES = 28;
 
-const float DELTA_ACCURACY = 20;
+// floats per cubie: offset to cubie 0 and scale, then per face the color (or the texture coordinate offset and the
+// shade). A drawn face of a cubie is its animation, the offset and scale and the data of that face.
+const int INSTANCE_SIZE = 22;
+const int FACE_INSTANCE_SIZE = 23;
 
 static glm::vec3 position = glm::vec3(0.0f, 0.0f, 10.0f);
 static GLfloat theta=0, phi=0;
 static GLfloat x_pos_old, y_pos_old;
 static GLfloat fov = 100.0f;
-static int nrRotations = 0;
 static bool s_clicked = false;
 static bool r_clicked = false;
 static int key_row = -1;
 static int key_axis = -1;
 static bool rotating = false;
-static GLfloat deltaTime = 0.0f;
-static int speed = 110;
 static bool cam_move = false;
 static bool solver = true;
-static int avCounter = DELTA_ACCURACY+5;
-static float avDeltaTime = 0.0;
-static float limit = 90.0;
-static float degLoss = 0.0;
-static bool lastRound = false;
 
-static GLint uniformAnim;
+// time base of the turns, the same on every machine and frame rate
+static AnimationClock animationClock;
+
 static array<array<GLfloat,6*36>,27> vtxArray;
 static array<array<GLfloat,5*36>,27> vtxArrayTex;
 
-static int xAxisArray[27];
-static int yAxisArray[27];
-static int zAxisArray[27];
-
-static int positionArray[3][3][3];
-
-static vector<int> cubePieceRotationsArray[27];
-
-static void initAxisArray() {
-    for (int i = 0; i < 27; i++ ) {
-        xAxisArray[i] = AXIS_RIGHT;
-        yAxisArray[i] = AXIS_UP;
-        zAxisArray[i] = AXIS_FRONT;
-    }
-}
-
-static void calcAvDeltaTimeAndLimit() {
-    avDeltaTime = avDeltaTime / DELTA_ACCURACY;
+// rotation of every cubie around CUBE_CENTER, snapped to whole quarter turns
+static glm::mat4 orientationArray[27];
 
-    limit = (int) (90.0 / (avDeltaTime*speed));
-    degLoss = 90 - (avDeltaTime*speed * limit);
-}
+// cubie at each position x + 3*y + 9*z, numbered like the move codes of the solver (movetable.h): the solver's y
+// (front->back) is the z axis of the scene, its z (bottom->top) the y axis of the scene
+static int positionArray[27];
 
-static void deltaTimeError() {
-    fprintf(stderr, "Cannot calculate delta time\n");
-    exit(EXIT_FAILURE);
-}
+// world axis of the scene for the axes of movetable.h
+static const glm::vec3 turnAxisArray[3] = {
+    glm::vec3(1.0f, 0.0f, 0.0f),
+    glm::vec3(0.0f, 0.0f, 1.0f),
+    glm::vec3(0.0f, 1.0f, 0.0f)
+};
 
+// one bit per cubie for each layer, index 3*moveAxis + moveLayer
+const uint32_t ALL_CUBIES = (1u << 27) - 1;
+static uint32_t layerMaskArray[9];
 
-static int getOrientationFromAxis(int i, glm::vec3 axis, int direction) {
-    GLfloat x = axis.x;
-    GLfloat y = axis.y;
-    GLfloat z = axis.z;
-
-    if(x == 1.0f) {
-        if(direction == UP_X && xAxisArray[i] == AXIS_LEFT) {
-            return -1;
-        } else if(direction == UP_X && xAxisArray[i] == AXIS_RIGHT) {
-            return 1;
-        } else if(direction == DOWN_X && xAxisArray[i] == AXIS_LEFT) {
-            return -1;
-        } else if(direction == DOWN_X && xAxisArray[i] == AXIS_RIGHT) {
-            return 1;
-        } else if(direction == LEFT_Z && xAxisArray[i] == AXIS_FRONT) {
-            return 1;
-        } else if(direction == LEFT_Z && xAxisArray[i] == AXIS_BACK) {
-            return -1;
-        } else if(direction == RIGHT_Z && xAxisArray[i] == AXIS_FRONT) {
-            return 1;
-        } else if(direction == RIGHT_Z && xAxisArray[i] == AXIS_BACK) {
-            return -1;
-        } else if(direction == LEFT_Y && xAxisArray[i] == AXIS_UP) {
-            return 1;
-        } else if(direction == LEFT_Y && xAxisArray[i] == AXIS_DOWN) {
-            return -1;
-        }  else if(direction == RIGHT_Y && xAxisArray[i] == AXIS_UP) {
-            return 1;
-        } else if(direction == RIGHT_Y && xAxisArray[i] == AXIS_DOWN) {
-            return -1;
-        }
+static vector<int> cubePieceRotationsArray[27];
 
-    } else if(y == 1.0f) {
-        if(direction == UP_X && yAxisArray[i] == AXIS_LEFT) {
-            return -1;
-        } else if(direction == UP_X && yAxisArray[i] == AXIS_RIGHT) {
-            return 1;
-        } else if(direction == DOWN_X && yAxisArray[i] == AXIS_LEFT) {
-            return -1;
-        } else if(direction == DOWN_X && yAxisArray[i] == AXIS_RIGHT) {
-            return 1;
-        } else if(direction == LEFT_Z && yAxisArray[i] == AXIS_FRONT) {
-            return 1;
-        } else if(direction == LEFT_Z && yAxisArray[i] == AXIS_BACK) {
-            return -1;
-        } else if(direction == RIGHT_Z && yAxisArray[i] == AXIS_FRONT) {
-            return 1;
-        } else if(direction == RIGHT_Z && yAxisArray[i] == AXIS_BACK) {
-            return -1;
-        } else if(direction == LEFT_Y && yAxisArray[i] == AXIS_UP) {
-            return 1;
-        } else if(direction == LEFT_Y && yAxisArray[i] == AXIS_DOWN) {
-            return -1;
-        }  else if(direction == RIGHT_Y && yAxisArray[i] == AXIS_UP) {
-            return 1;
-        } else if(direction == RIGHT_Y && yAxisArray[i] == AXIS_DOWN) {
-            return -1;
-        }
+// the cube as shown, kept in sync by changeCubePositions, and its solution
+static CubeState liveState;
+static BackgroundSolver* liveSolver = NULL;
 
-    } else if(z == 1.0f) {
-        if(direction == UP_X && zAxisArray[i] == AXIS_LEFT) {
-            return -1;
-        } else if(direction == UP_X && zAxisArray[i] == AXIS_RIGHT) {
-            return 1;
-        } else if(direction == DOWN_X && zAxisArray[i] == AXIS_LEFT) {
-            return -1;
-        } else if(direction == DOWN_X && zAxisArray[i] == AXIS_RIGHT) {
-            return 1;
-        } else if(direction == LEFT_Z && zAxisArray[i] == AXIS_FRONT) {
-            return 1;
-        } else if(direction == LEFT_Z && zAxisArray[i] == AXIS_BACK) {
-            return -1;
-        } else if(direction == RIGHT_Z && zAxisArray[i] == AXIS_FRONT) {
-            return 1;
-        } else if(direction == RIGHT_Z && zAxisArray[i] == AXIS_BACK) {
-            return -1;
-        } else if(direction == LEFT_Y && zAxisArray[i] == AXIS_UP) {
-            return 1;
-        } else if(direction == LEFT_Y && zAxisArray[i] == AXIS_DOWN) {
-            return -1;
-        }  else if(direction == RIGHT_Y && zAxisArray[i] == AXIS_UP) {
-            return 1;
-        } else if(direction == RIGHT_Y && zAxisArray[i] == AXIS_DOWN) {
-            return -1;
-        }
-      }
-    return 1;
-}
+// the next scramble for 'r' and its solution, both made in the background
+static ScrambleTask* scrambleTask = NULL;
+static bool scramblePlayed = false;
 
-static glm::vec3 calcAxis(int i, glm::vec3 axis, int direction) {
-
-    int x = xAxisArray[i];
-    int y = yAxisArray[i];
-    int z = zAxisArray[i];
-
-    if(direction == LEFT_Z)  {
-        if(x == AXIS_FRONT || x == AXIS_BACK) {
-           axis.x = 1.0f;
-           axis.y = 0.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( y == AXIS_FRONT || y == AXIS_BACK) {
-           axis.x = 0.0f;
-           axis.y = 1.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( z == AXIS_FRONT || z == AXIS_BACK) {
-           axis.x = 0.0f;
-           axis.y = 0.0f;
-           axis.z = 1.0f;
-           return axis;
-        }
-    } else if(direction == RIGHT_Z) {
-        if(x == AXIS_FRONT || x == AXIS_BACK) {
-           axis.x = 1.0f;
-           axis.y = 0.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( y == AXIS_FRONT || y == AXIS_BACK) {
-           axis.x = 0.0f;
-           axis.y = 1.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( z == AXIS_FRONT || z == AXIS_BACK) {
-           axis.x = 0.0f;
-           axis.y = 0.0f;
-           axis.z = 1.0f;
-           return axis;
-        }
-    } else if(direction == UP_X) {
-        if(x == AXIS_LEFT || x == AXIS_RIGHT) {
-           axis.x = 1.0f;
-           axis.y = 0.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( y == AXIS_LEFT || y == AXIS_RIGHT) {
-           axis.x = 0.0f;
-           axis.y = 1.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( z == AXIS_LEFT || z == AXIS_RIGHT) {
-           axis.x = 0.0f;
-           axis.y = 0.0f;
-           axis.z = 1.0f;
-           return axis;
-        }
-    } else if(direction == DOWN_X) {
-        if(x == AXIS_LEFT || x == AXIS_RIGHT) {
-           axis.x = 1.0f;
-           axis.y = 0.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( y == AXIS_LEFT || y == AXIS_RIGHT) {
-           axis.x = 0.0f;
-           axis.y = 1.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( z == AXIS_LEFT || z == AXIS_RIGHT) {
-           axis.x = 0.0f;
-           axis.y = 0.0f;
-           axis.z = 1.0f;
-           return axis;
-        }
-    } else if(direction == LEFT_Y) {
-        if(x == AXIS_UP || x == AXIS_DOWN) {
-           axis.x = 1.0f;
-           axis.y = 0.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( y == AXIS_UP || y == AXIS_DOWN) {
-           axis.x = 0.0f;
-           axis.y = 1.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( z == AXIS_UP || z == AXIS_DOWN) {
-           axis.x = 0.0f;
-           axis.y = 0.0f;
-           axis.z = 1.0f;
-           return axis;
-        }
-    } else if(direction == RIGHT_Y) {
-        if(x == AXIS_UP || x == AXIS_DOWN) {
-           axis.x = 1.0f;
-           axis.y = 0.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( y == AXIS_UP || y == AXIS_DOWN) {
-           axis.x = 0.0f;
-           axis.y = 1.0f;
-           axis.z = 0.0f;
-           return axis;
-        } else if( z == AXIS_UP || z == AXIS_DOWN) {
-           axis.x = 0.0f;
-           axis.y = 0.0f;
-           axis.z = 1.0f;
-           return axis;
-        }
+static void initOrientationArray() {
+    for (int i = 0; i < 27; i++ ) {
+        orientationArray[i] = glm::mat4(1.0f);
     }
-    return axis;
 }
 
-static void setAxis(int i, glm::vec3 axis, int direction) {
-
-    GLfloat vX = axis.x;
-    GLfloat vY = axis.y;
-    GLfloat vZ = axis.z;
-
-    int x = xAxisArray[i];
-    int y = yAxisArray[i];
-    int z = zAxisArray[i];
-    // (vx, vy, vz)
-    // _____________
-    // ( 1, 0,  0) ->
-    // ( 0, 1,  0)
-    // ( 0, 0,  1)
-
-
-    if(direction == LEFT_Z )  {
-        if(vX == 1.0f) {
-            if(x == AXIS_FRONT) {
-                yAxisArray[i] = z;
-                zAxisArray[i] = -y;
-            } else if(x == AXIS_BACK) {
-                yAxisArray[i] = -z;
-                zAxisArray[i] = y;
-            }
-        } else if( vY == 1.0f) {
-            if(y == AXIS_FRONT) {
-                xAxisArray[i] = -z;
-                zAxisArray[i] = x;
-            } else if(y == AXIS_BACK) {
-                xAxisArray[i] = z;
-                zAxisArray[i] = -x;
-            }
-        } else if( vZ == 1.0f) {
-            if(z == AXIS_FRONT) {
-                xAxisArray[i] = y;
-                yAxisArray[i] = -x;
-            } else if(z == AXIS_BACK) {
-                xAxisArray[i] = -y;
-                yAxisArray[i] = x;
-            }
-        }
-    } else if(direction == RIGHT_Z) {
-        if(vX == 1.0f) {
-            if(x == AXIS_FRONT) {
-                yAxisArray[i] = -z;
-                zAxisArray[i] = y;
-            } else if(x == AXIS_BACK) {
-                yAxisArray[i] = z;
-                zAxisArray[i] = -y;
-            }
-        } else if( vY == 1.0f) {
-            if(y == AXIS_FRONT) {
-                xAxisArray[i] = z;
-                zAxisArray[i] = -x;
-            } else if(y == AXIS_BACK) {
-                xAxisArray[i] = -z;
-                zAxisArray[i] = x;
-            }
-        } else if( vZ == 1.0f) {
-            if(z == AXIS_FRONT) {
-                xAxisArray[i] = -y;
-                yAxisArray[i] = x;
-            } else if(z == AXIS_BACK) {
-                xAxisArray[i] = y;
-                yAxisArray[i] = -x;
-            }
-        }
-    } else if(direction == UP_X) {
-        if(vX == 1.0f) {
-            if(x == AXIS_LEFT) {
-                yAxisArray[i] = z;
-                zAxisArray[i] = -y;
-            } else if(x == AXIS_RIGHT) {
-                yAxisArray[i] = -z;
-                zAxisArray[i] = y;
-            }
-        } else if( vY == 1.0f) {
-            if(y == AXIS_LEFT) {
-                xAxisArray[i] = -z;
-                zAxisArray[i] = x;
-            } else if(y == AXIS_RIGHT) {
-                xAxisArray[i] = z;
-                zAxisArray[i] = -x;
-            }
-        } else if( vZ == 1.0f) {
-            if(z == AXIS_LEFT) {
-                xAxisArray[i] = y;
-                yAxisArray[i] = -x;
-            } else if(z == AXIS_RIGHT) {
-                xAxisArray[i] = -y;
-                yAxisArray[i] = x;
-            }
-        }
-    } else if(direction == DOWN_X) {
-        if(vX == 1.0f) {
-            if(x == AXIS_LEFT) {
-                yAxisArray[i] = -z;
-                zAxisArray[i] = y;
-            } else if(x == AXIS_RIGHT) {
-                yAxisArray[i] = z;
-                zAxisArray[i] = -y;
-            }
-        } else if( vY == 1.0f) {
-            if(y == AXIS_LEFT) {
-                xAxisArray[i] = z;
-                zAxisArray[i] = -x;
-            } else if(y == AXIS_RIGHT) {
-                xAxisArray[i] = -z;
-                zAxisArray[i] = x;
-            }
-        } else if( vZ == 1.0f) {
-            if(z == AXIS_LEFT) {
-                xAxisArray[i] = -y;
-                yAxisArray[i] = x;
-            } else if(z == AXIS_RIGHT) {
-                xAxisArray[i] = y;
-                yAxisArray[i] = -x;
-            }
-        }
-    } else if(direction == LEFT_Y) {
-        if(vX == 1.0f) {
-            if(x == AXIS_UP) {
-                yAxisArray[i] = z;
-                zAxisArray[i] = -y;
-            } else if(x == AXIS_DOWN) {
-                yAxisArray[i] = -z;
-                zAxisArray[i] = y;
-            }
-        } else if( vY == 1.0f) {
-            if(y == AXIS_UP) {
-                xAxisArray[i] = -z;
-                zAxisArray[i] = x;
-            } else if(y == AXIS_DOWN) {
-                xAxisArray[i] = z;
-                zAxisArray[i] = -x;
-            }
-        } else if( vZ == 1.0f) {
-            if(z == AXIS_UP) {
-                xAxisArray[i] = y;
-                yAxisArray[i] = -x;
-            } else if(z == AXIS_DOWN) {
-                xAxisArray[i] = -y;
-                yAxisArray[i] = x;
-            }
-        }
-    } else if(direction == RIGHT_Y) {
-        if(vX == 1.0f) {
-            if(x == AXIS_UP) {
-                yAxisArray[i] = -z;
-                zAxisArray[i] = y;
-            } else if(x == AXIS_DOWN) {
-                yAxisArray[i] = z;
-                zAxisArray[i] = -y;
-            }
-        } else if( vY == 1.0f) {
-            if(y == AXIS_UP) {
-                xAxisArray[i] = z;
-                zAxisArray[i] = -x;
-            } else if(y == AXIS_DOWN) {
-                xAxisArray[i] = -z;
-                zAxisArray[i] = x;
-            }
-        } else if( vZ == 1.0f) {
-            if(z == AXIS_UP) {
-                xAxisArray[i] = -y;
-                yAxisArray[i] = x;
-            } else if(z == AXIS_DOWN) {
-                xAxisArray[i] = y;
-                yAxisArray[i] = -x;
-            }
-        }
-    }
-
-
-}
 
 static void initPositionArray() {
     unsigned x, y, z, depth;
@@ -493,41 +123,159 @@ static void initPositionArray() {
             for (x = 0; x < 3; x++) {
                 if (z == 0) {
                     if (x == 0) {
-                        positionArray[x][y][z] = BOTTOM_LEFT + depth;
+                        positionArray[x + 3*y + 9*z] = BOTTOM_LEFT + depth;
                     }
                     else if (x == 1) {
-                        positionArray[x][y][z] = BOTTOM + depth;
+                        positionArray[x + 3*y + 9*z] = BOTTOM + depth;
                     }
                     else if (x == 2) {
-                        positionArray[x][y][z] = BOTTOM_RIGHT + depth;
+                        positionArray[x + 3*y + 9*z] = BOTTOM_RIGHT + depth;
                     }
                 }
                 else if (z == 1) {
                     if (x == 0) {
-                        positionArray[x][y][z] = LEFT + depth;
+                        positionArray[x + 3*y + 9*z] = LEFT + depth;
                     }
                     else if (x == 1) {
-                        positionArray[x][y][z] = MIDDLE + depth;
+                        positionArray[x + 3*y + 9*z] = MIDDLE + depth;
                     }
                     else if (x == 2) {
-                        positionArray[x][y][z] = RIGHT + depth;
+                        positionArray[x + 3*y + 9*z] = RIGHT + depth;
                     }
                 }
                 else if (z == 2) {
                     if (x == 0) {
-                        positionArray[x][y][z] = TOP_LEFT + depth;
+                        positionArray[x + 3*y + 9*z] = TOP_LEFT + depth;
                     }
                     else if (x == 1) {
-                        positionArray[x][y][z] = TOP + depth;
+                        positionArray[x + 3*y + 9*z] = TOP + depth;
                     }
                     else if (x == 2) {
-                        positionArray[x][y][z] = TOP_RIGHT + depth;
+                        positionArray[x + 3*y + 9*z] = TOP_RIGHT + depth;
                     }
                 }
             }
         }
     }
 }
+
+// a turn moves cubies inside their layer along the turn axis only, but rebuilding all nine masks is just as cheap
+static void updateLayerMasks() {
+    unsigned position;
+    uint32_t bit;
+
+    for (position = 0; position < 9; position++) {
+        layerMaskArray[position] = 0;
+    }
+    for (position = 0; position < 27; position++) {
+        bit = 1u << positionArray[position];
+        layerMaskArray[position % 3] |= bit;
+        layerMaskArray[3 + position / 3 % 3] |= bit;
+        layerMaskArray[6 + position / 9] |= bit;
+    }
+}
+
+// cubies the renderer turns for move (0 if there is none)
+static uint32_t getTurningCubies(int move) {
+    if (move < 0 || move >= NR_MOVES) {
+        return 0;
+    } else if (moveLayer(move) < 0) {
+        return ALL_CUBIES;
+    }
+    return layerMaskArray[3*moveAxis(move) + moveLayer(move)];
+}
+
+// cubies that need their inward faces during a turn of the group: the turning ones and the ones in the layers next
+// to a turning layer, which the turn uncovers. The body is not drawn then, so a whole cube turn opens every cubie.
+static uint32_t getOpenCubies(const int group[3], unsigned groupSize) {
+    uint32_t open = 0;
+    unsigned layers = 0, neighbours, layer, g;
+
+    for (g = 0; g < groupSize; g++) {
+        if (group[g] < 0 || group[g] >= NR_MOVES) {
+            continue;
+        } else if (moveLayer(group[g]) < 0) {
+            return ALL_CUBIES;
+        }
+        open |= getTurningCubies(group[g]);
+        layers |= 1u << moveLayer(group[g]);
+    }
+    // the moves of a group share their axis (getTurnGroup)
+    neighbours = (layers << 1 | layers >> 1) & ~layers;
+    for (layer = 0; layer < 3; layer++) {
+        if ((neighbours & (1u << layer)) != 0) {
+            open |= layerMaskArray[3*moveAxis(group[0]) + layer];
+        }
+    }
+    return open;
+}
+
+// instances of the 6 face draws, one face after the other: every cubie shows its outward faces
+// (Cube::getOutwardFaces), the open cubies all faces and, while no cubie is open, the body fills the gaps. counts
+// gets the instances of each face. Returns the number of instances.
+static GLsizei buildFaceInstances(uint32_t openCubies, const GLuint* outwardFaces, const glm::mat4* anims,
+                                  const GLfloat* instances, GLfloat* faceInstances, GLsizei counts[6]) {
+    GLsizei total = 0;
+    GLuint faces;
+    GLfloat* out;
+    int cubie, face;
+
+    for (face = 0; face < 6; face++) {
+        counts[face] = 0;
+        for (cubie = 0; cubie < NR_CUBIES; cubie++) {
+            if (cubie == NR_CUBIES - 1) {
+                faces = openCubies == 0 ? 63 : 0;
+            } else {
+                faces = (openCubies & (1u << cubie)) != 0 ? 63 : outwardFaces[cubie];
+            }
+            if ((faces & (1u << face)) == 0) {
+                continue;
+            }
+            out = &faceInstances[total*FACE_INSTANCE_SIZE];
+            memcpy(out, glm::value_ptr(anims[cubie]), 16*sizeof(GLfloat));
+            memcpy(out + 16, &instances[cubie*INSTANCE_SIZE], 4*sizeof(GLfloat));
+            memcpy(out + 20, &instances[cubie*INSTANCE_SIZE + 4 + face*3], 3*sizeof(GLfloat));
+            counts[face]++;
+            total++;
+        }
+    }
+    return total;
+}
+
+// points the instance attributes (animation at locations 2 to 5, offset 6, face 7) at face instance first of the
+// bound buffer: GL 3.3 has no base instance, so this is how a face draw starts at its own instances
+static void setFaceInstances(GLsizei first) {
+    const GLsizei stride = FACE_INSTANCE_SIZE * sizeof(GLfloat);
+    size_t offset = first * stride;
+
+    for (int c = 0; c < 4; c++) {
+        glVertexAttribPointer(2 + c, 4, GL_FLOAT, GL_FALSE, stride, (void*) (offset + c * sizeof(glm::vec4)));
+    }
+    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride, (void*) (offset + 16 * sizeof(GLfloat)));
+    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, stride, (void*) (offset + 20 * sizeof(GLfloat)));
+}
+
+// moves from moves[first] on that turn at the same time: layers of one axis share no cubie, so the following moves
+// on other layers of the same axis join the turn. A whole cube turn or a layer that is already in stays for the next.
+static unsigned getTurnGroup(const vector<int>& moves, unsigned first, int group[3]) {
+    unsigned size = 0, layers = 0, i;
+    int move;
+
+    for (i = first; i < moves.size() && size < 3; i++) {
+        move = moves[i];
+        if (move < 0 || move >= NR_MOVES || moveLayer(move) < 0 || (layers & (1u << moveLayer(move))) != 0
+            || (size > 0 && moveAxis(move) != moveAxis(group[0]))) {
+            break;
+        }
+        layers |= 1u << moveLayer(move);
+        group[size++] = move;
+    }
+    if (size == 0) {
+        group[size++] = moves[first];
+    }
+    return size;
+}
+
 /*                                                                           */
 /* GLFW callback functions for event handling                                */
 /*                                                                           */
@@ -546,7 +294,7 @@ static void keyCallback(GLFWwindow* myWindow, int key, int scanCode,
         glfwSetWindowShouldClose(myWindow, GL_TRUE);
     }
 
-    if ((key == GLFW_KEY_S) && action == GLFW_PRESS && r_clicked == true) {
+    if ((key == GLFW_KEY_S) && action == GLFW_PRESS) {
       s_clicked = true;
     } else if ((key == GLFW_KEY_R) && action == GLFW_PRESS) {
       solver = false;
@@ -557,6 +305,21 @@ static void keyCallback(GLFWwindow* myWindow, int key, int scanCode,
       position = glm::vec3(4.0f, 4.0f, 6.0f);
     }
 
+    /* +/- double or halve the turn speed, also in the middle of a turn; past the maximum turns take no time */
+    if ((key == GLFW_KEY_KP_ADD || key == GLFW_KEY_EQUAL) && action == GLFW_PRESS) {
+      if (!animationClock.isUnbounded())
+        animationClock.setSpeed(animationClock.getSpeed() * 2);
+    } else if ((key == GLFW_KEY_KP_SUBTRACT || key == GLFW_KEY_MINUS) && action == GLFW_PRESS) {
+      animationClock.setSpeed(animationClock.isUnbounded() ? MAX_TURN_SPEED : animationClock.getSpeed() / 2);
+    }
+    if ((key == GLFW_KEY_KP_ADD || key == GLFW_KEY_EQUAL || key == GLFW_KEY_KP_SUBTRACT || key == GLFW_KEY_MINUS)
+        && action == GLFW_PRESS) {
+      if (animationClock.isUnbounded())
+        cout << "speed: unbounded" << endl;
+      else
+        cout << "speed: " << animationClock.getSpeed() << "x" << endl;
+    }
+
     if (rotating == true)
       cout << "wait until current roation is finished!" << endl;
 
@@ -566,10 +329,10 @@ static void keyCallback(GLFWwindow* myWindow, int key, int scanCode,
             cout << "X" << endl;
         } else if ((key == GLFW_KEY_Z) && action == GLFW_PRESS) {
             cout << "Y" << endl;
-            key_axis = 1;
+            key_axis = 2;
         } else if ((key == GLFW_KEY_C) && action == GLFW_PRESS) {
             cout << "Z" << endl;
-            key_axis = 2;
+            key_axis = 1;
         } else if ((key == GLFW_KEY_1) && action == GLFW_PRESS) {
             cout << "1.Row Right" << endl;
             key_row = 0;
@@ -592,51 +355,10 @@ static void keyCallback(GLFWwindow* myWindow, int key, int scanCode,
     }
 }
 
+// key_axis is the axis of movetable.h, key_row 0-2 the layer, 3-5 the layer reverse
 static int getMove() {
     if(key_row != -1 && key_axis != -1) {
-        if (key_axis == 0) {
-            if (key_row == 0) {
-                return 6;
-            } else if (key_row == 1) {
-                return 7;
-            } else if (key_row == 2) {
-                return 8;
-            } else if (key_row == 3) {
-                return 9;
-            } else if (key_row == 4) {
-                return 10;
-            } else if (key_row == 5) {
-                return 11;
-            }
-          } else if (key_axis == 2){
-              if (key_row == 0) {
-                  return 12;
-              } else if (key_row == 1) {
-                  return 13;
-              } else if (key_row == 2) {
-                  return 14;
-              } else if (key_row == 3) {
-                  return 15;
-              } else if (key_row == 4) {
-                  return 16;
-              } else if (key_row == 5) {
-                  return 17;
-              }
-          } else if (key_axis == 1){
-              if (key_row == 0) {
-                  return 18;
-              } else if (key_row == 1) {
-                  return 19;
-              } else if (key_row == 2) {
-                  return 20;
-              } else if (key_row == 3) {
-                  return 21;
-              } else if (key_row == 4) {
-                  return 22;
-              } else if (key_row == 5) {
-                  return 23;
-              }
-        }
+        return moveCode(key_axis, key_row % 3, key_row >= 3);
     }
     return -1;
 }
@@ -720,1007 +442,143 @@ bool checkShaderProgramLinkStatus(GLuint programID)
 }
 
 void changeCubePositions(int move) {
-  unsigned x, y, z;
-  int tmp;
-
-  if(move == 0) {
-      for(int x = 0; x < 3; x++) {
-        // moving corner pieces
-        tmp = positionArray[x][0][2];
-        positionArray[x][0][2] = positionArray[x][0][0];
-        positionArray[x][0][0] = positionArray[x][2][0];
-        positionArray[x][2][0] = positionArray[x][2][2];
-        positionArray[x][2][2] = tmp;
-
-        // moving edge positionArray
-        tmp = positionArray[x][0][1];
-        positionArray[x][0][1] = positionArray[x][1][0];
-        positionArray[x][1][0] = positionArray[x][2][1];
-        positionArray[x][2][1] = positionArray[x][1][2];
-        positionArray[x][1][2] = tmp;
-      }
-    } else if (move == 1) {
-      x = 0;
-      for (int x = 0; x < 3; x++) {
-        tmp = positionArray[x][2][0];
-        positionArray[x][2][0] = positionArray[x][0][0];
-        positionArray[x][0][0] = positionArray[x][0][2];
-        positionArray[x][0][2] = positionArray[x][2][2];
-        positionArray[x][2][2] = tmp;
-
-        // moving edge positionArray
-        tmp = positionArray[x][1][0];
-        positionArray[x][1][0] = positionArray[x][0][1];
-        positionArray[x][0][1] = positionArray[x][1][2];
-        positionArray[x][1][2] = positionArray[x][2][1];
-        positionArray[x][2][1] = tmp;
-      }
-    } else if (move == 2) {
-      y = 0;
-      for (int y = 0; y < 3; y++) {
-        tmp = positionArray[0][y][2];
-        positionArray[0][y][2] = positionArray[0][y][0];
-        positionArray[0][y][0] = positionArray[2][y][0];
-        positionArray[2][y][0] = positionArray[2][y][2];
-        positionArray[2][y][2] = tmp;
-
-        // moving edge positionArray
-        tmp = positionArray[0][y][1];
-        positionArray[0][y][1] = positionArray[1][y][0];
-        positionArray[1][y][0] = positionArray[2][y][1];
-        positionArray[2][y][1] = positionArray[1][y][2];
-        positionArray[1][y][2] = tmp;
-      }
-    } else if (move == 3) {
-      y = 0;
-      for (int y = 0; y < 3; y++) {
-        tmp = positionArray[2][y][0];
-        positionArray[2][y][0] = positionArray[0][y][0];
-        positionArray[0][y][0] = positionArray[0][y][2];
-        positionArray[0][y][2] = positionArray[2][y][2];
-        positionArray[2][y][2] = tmp;
-
-        // moving edge positionArray
-        tmp = positionArray[1][y][0];
-        positionArray[1][y][0] = positionArray[0][y][1];
-        positionArray[0][y][1] = positionArray[1][y][2];
-        positionArray[1][y][2] = positionArray[2][y][1];
-        positionArray[2][y][1] = tmp;
-      }
-    } else if (move == 5) {
-      z = 0;
-      for (int z = 0; z < 3; z++) {
-        tmp = positionArray[2][0][z];
-        positionArray[2][0][z] = positionArray[0][0][z];
-        positionArray[0][0][z] = positionArray[0][2][z];
-        positionArray[0][2][z] = positionArray[2][2][z];
-        positionArray[2][2][z] = tmp;
-
-        // moving edge positionArray
-        tmp = positionArray[1][0][z];
-        positionArray[1][0][z] = positionArray[0][1][z];
-        positionArray[0][1][z] = positionArray[1][2][z];
-        positionArray[1][2][z] = positionArray[2][1][z];
-        positionArray[2][1][z] = tmp;
-      }
-    } else if (move == 4) {
-      z = 0;
-      for (int z = 0; z < 3; z++) {
-        tmp = positionArray[0][2][z];
-        positionArray[0][2][z] = positionArray[0][0][z];
-        positionArray[0][0][z] = positionArray[2][0][z];
-        positionArray[2][0][z] = positionArray[2][2][z];
-        positionArray[2][2][z] = tmp;
-
-        // moving edge positionArray
-        tmp = positionArray[0][1][z];
-        positionArray[0][1][z] = positionArray[1][0][z];
-        positionArray[1][0][z] = positionArray[2][1][z];
-        positionArray[2][1][z] = positionArray[1][2][z];
-        positionArray[1][2][z] = tmp;
-      }
-
-    } else if (move == 6) {
-        x = 0;
-        // moving corner pieces
-        tmp = positionArray[x][0][2];
-        positionArray[x][0][2] = positionArray[x][0][0];
-        positionArray[x][0][0] = positionArray[x][2][0];
-        positionArray[x][2][0] = positionArray[x][2][2];
-        positionArray[x][2][2] = tmp;
-
-        // moving edge positionArray
-        tmp = positionArray[x][0][1];
-        positionArray[x][0][1] = positionArray[x][1][0];
-        positionArray[x][1][0] = positionArray[x][2][1];
-        positionArray[x][2][1] = positionArray[x][1][2];
-        positionArray[x][1][2] = tmp;
-  }
-  else if (move == 7) {
-      x = 1;
-      // moving corner pieces
-      tmp = positionArray[x][0][2];
-      positionArray[x][0][2] = positionArray[x][0][0];
-      positionArray[x][0][0] = positionArray[x][2][0];
-      positionArray[x][2][0] = positionArray[x][2][2];
-      positionArray[x][2][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[x][0][1];
-      positionArray[x][0][1] = positionArray[x][1][0];
-      positionArray[x][1][0] = positionArray[x][2][1];
-      positionArray[x][2][1] = positionArray[x][1][2];
-      positionArray[x][1][2] = tmp;
-  }
-  else if (move == 8) {
-      x = 2;
-      // moving corner pieces
-      tmp = positionArray[x][0][2];
-      positionArray[x][0][2] = positionArray[x][0][0];
-      positionArray[x][0][0] = positionArray[x][2][0];
-      positionArray[x][2][0] = positionArray[x][2][2];
-      positionArray[x][2][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[x][0][1];
-      positionArray[x][0][1] = positionArray[x][1][0];
-      positionArray[x][1][0] = positionArray[x][2][1];
-      positionArray[x][2][1] = positionArray[x][1][2];
-      positionArray[x][1][2] = tmp;
-  }
-  else if (move == 9) {
-      x = 0;
-      // moving corner pieces
-      tmp = positionArray[x][2][0];
-      positionArray[x][2][0] = positionArray[x][0][0];
-      positionArray[x][0][0] = positionArray[x][0][2];
-      positionArray[x][0][2] = positionArray[x][2][2];
-      positionArray[x][2][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[x][1][0];
-      positionArray[x][1][0] = positionArray[x][0][1];
-      positionArray[x][0][1] = positionArray[x][1][2];
-      positionArray[x][1][2] = positionArray[x][2][1];
-      positionArray[x][2][1] = tmp;
-  }
-  else if (move == 10) {
-      x = 1;
-      // moving corner pieces
-      tmp = positionArray[x][2][0];
-      positionArray[x][2][0] = positionArray[x][0][0];
-      positionArray[x][0][0] = positionArray[x][0][2];
-      positionArray[x][0][2] = positionArray[x][2][2];
-      positionArray[x][2][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[x][1][0];
-      positionArray[x][1][0] = positionArray[x][0][1];
-      positionArray[x][0][1] = positionArray[x][1][2];
-      positionArray[x][1][2] = positionArray[x][2][1];
-      positionArray[x][2][1] = tmp;
-  }
-  else if (move == 11) {
-      x = 2;
-      // moving corner pieces
-      tmp = positionArray[x][2][0];
-      positionArray[x][2][0] = positionArray[x][0][0];
-      positionArray[x][0][0] = positionArray[x][0][2];
-      positionArray[x][0][2] = positionArray[x][2][2];
-      positionArray[x][2][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[x][1][0];
-      positionArray[x][1][0] = positionArray[x][0][1];
-      positionArray[x][0][1] = positionArray[x][1][2];
-      positionArray[x][1][2] = positionArray[x][2][1];
-      positionArray[x][2][1] = tmp;
-  }
-  else if (move == 12) {
-      y = 0;
-      // moving corner pieces
-      tmp = positionArray[0][y][2];
-      positionArray[0][y][2] = positionArray[0][y][0];
-      positionArray[0][y][0] = positionArray[2][y][0];
-      positionArray[2][y][0] = positionArray[2][y][2];
-      positionArray[2][y][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[0][y][1];
-      positionArray[0][y][1] = positionArray[1][y][0];
-      positionArray[1][y][0] = positionArray[2][y][1];
-      positionArray[2][y][1] = positionArray[1][y][2];
-      positionArray[1][y][2] = tmp;
-  }
-  else if (move == 13) {
-      y = 1;
-      // moving corner pieces
-      tmp = positionArray[0][y][2];
-      positionArray[0][y][2] = positionArray[0][y][0];
-      positionArray[0][y][0] = positionArray[2][y][0];
-      positionArray[2][y][0] = positionArray[2][y][2];
-      positionArray[2][y][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[0][y][1];
-      positionArray[0][y][1] = positionArray[1][y][0];
-      positionArray[1][y][0] = positionArray[2][y][1];
-      positionArray[2][y][1] = positionArray[1][y][2];
-      positionArray[1][y][2] = tmp;
-  }
-  else if (move == 14) {
-      y = 2;
-      // moving corner pieces
-      tmp = positionArray[0][y][2];
-      positionArray[0][y][2] = positionArray[0][y][0];
-      positionArray[0][y][0] = positionArray[2][y][0];
-      positionArray[2][y][0] = positionArray[2][y][2];
-      positionArray[2][y][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[0][y][1];
-      positionArray[0][y][1] = positionArray[1][y][0];
-      positionArray[1][y][0] = positionArray[2][y][1];
-      positionArray[2][y][1] = positionArray[1][y][2];
-      positionArray[1][y][2] = tmp;
-  }
-  else if (move == 15) {
-      y = 0;
-      // moving corner pieces
-      tmp = positionArray[2][y][0];
-      positionArray[2][y][0] = positionArray[0][y][0];
-      positionArray[0][y][0] = positionArray[0][y][2];
-      positionArray[0][y][2] = positionArray[2][y][2];
-      positionArray[2][y][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[1][y][0];
-      positionArray[1][y][0] = positionArray[0][y][1];
-      positionArray[0][y][1] = positionArray[1][y][2];
-      positionArray[1][y][2] = positionArray[2][y][1];
-      positionArray[2][y][1] = tmp;
-  }
-  else if (move == 16) {
-      y = 1;
-      // moving corner pieces
-      tmp = positionArray[2][y][0];
-      positionArray[2][y][0] = positionArray[0][y][0];
-      positionArray[0][y][0] = positionArray[0][y][2];
-      positionArray[0][y][2] = positionArray[2][y][2];
-      positionArray[2][y][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[1][y][0];
-      positionArray[1][y][0] = positionArray[0][y][1];
-      positionArray[0][y][1] = positionArray[1][y][2];
-      positionArray[1][y][2] = positionArray[2][y][1];
-      positionArray[2][y][1] = tmp;
-  }
-  else if (move == 17) {
-      y = 2;
-      // moving corner pieces
-      tmp = positionArray[2][y][0];
-      positionArray[2][y][0] = positionArray[0][y][0];
-      positionArray[0][y][0] = positionArray[0][y][2];
-      positionArray[0][y][2] = positionArray[2][y][2];
-      positionArray[2][y][2] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[1][y][0];
-      positionArray[1][y][0] = positionArray[0][y][1];
-      positionArray[0][y][1] = positionArray[1][y][2];
-      positionArray[1][y][2] = positionArray[2][y][1];
-      positionArray[2][y][1] = tmp;
-  }
-  else if (move == 18) {
-      z = 0;
-      // moving corner pieces
-      tmp = positionArray[0][2][z];
-      positionArray[0][2][z] = positionArray[0][0][z];
-      positionArray[0][0][z] = positionArray[2][0][z];
-      positionArray[2][0][z] = positionArray[2][2][z];
-      positionArray[2][2][z] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[0][1][z];
-      positionArray[0][1][z] = positionArray[1][0][z];
-      positionArray[1][0][z] = positionArray[2][1][z];
-      positionArray[2][1][z] = positionArray[1][2][z];
-      positionArray[1][2][z] = tmp;
-  }
-  else if (move == 19) {
-      z = 1;
-      // moving corner pieces
-      tmp = positionArray[0][2][z];
-      positionArray[0][2][z] = positionArray[0][0][z];
-      positionArray[0][0][z] = positionArray[2][0][z];
-      positionArray[2][0][z] = positionArray[2][2][z];
-      positionArray[2][2][z] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[0][1][z];
-      positionArray[0][1][z] = positionArray[1][0][z];
-      positionArray[1][0][z] = positionArray[2][1][z];
-      positionArray[2][1][z] = positionArray[1][2][z];
-      positionArray[1][2][z] = tmp;
-  }
-  else if (move == 20) {
-      z = 2;
-      // moving corner pieces
-      tmp = positionArray[0][2][z];
-      positionArray[0][2][z] = positionArray[0][0][z];
-      positionArray[0][0][z] = positionArray[2][0][z];
-      positionArray[2][0][z] = positionArray[2][2][z];
-      positionArray[2][2][z] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[0][1][z];
-      positionArray[0][1][z] = positionArray[1][0][z];
-      positionArray[1][0][z] = positionArray[2][1][z];
-      positionArray[2][1][z] = positionArray[1][2][z];
-      positionArray[1][2][z] = tmp;
-  }
-  else if (move == 21) {
-      z = 0;
-      // moving corner pieces
-      tmp = positionArray[2][0][z];
-      positionArray[2][0][z] = positionArray[0][0][z];
-      positionArray[0][0][z] = positionArray[0][2][z];
-      positionArray[0][2][z] = positionArray[2][2][z];
-      positionArray[2][2][z] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[1][0][z];
-      positionArray[1][0][z] = positionArray[0][1][z];
-      positionArray[0][1][z] = positionArray[1][2][z];
-      positionArray[1][2][z] = positionArray[2][1][z];
-      positionArray[2][1][z] = tmp;
-  }
-  else if (move == 22) {
-      z = 1;
-      // moving corner pieces
-      tmp = positionArray[2][0][z];
-      positionArray[2][0][z] = positionArray[0][0][z];
-      positionArray[0][0][z] = positionArray[0][2][z];
-      positionArray[0][2][z] = positionArray[2][2][z];
-      positionArray[2][2][z] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[1][0][z];
-      positionArray[1][0][z] = positionArray[0][1][z];
-      positionArray[0][1][z] = positionArray[1][2][z];
-      positionArray[1][2][z] = positionArray[2][1][z];
-      positionArray[2][1][z] = tmp;
-  }
-  else if (move == 23) {
-      z = 2;
-      // moving corner pieces
-      tmp = positionArray[2][0][z];
-      positionArray[2][0][z] = positionArray[0][0][z];
-      positionArray[0][0][z] = positionArray[0][2][z];
-      positionArray[0][2][z] = positionArray[2][2][z];
-      positionArray[2][2][z] = tmp;
-
-      // moving edge positionArray
-      tmp = positionArray[1][0][z];
-      positionArray[1][0][z] = positionArray[0][1][z];
-      positionArray[0][1][z] = positionArray[1][2][z];
-      positionArray[1][2][z] = positionArray[2][1][z];
-      positionArray[2][1][z] = tmp;
-  }
+  int previous[27];
+  unsigned position;
 
-}
+  liveState.applyMove(move);
+  if (liveSolver != NULL)
+      liveSolver->update(liveState, move);
 
-void createAnim(GLuint shaderProgram, glm::mat4 anim) {
-  const char* uniformName = "anim";
-  uniformAnim = glGetUniformLocation(shaderProgram, uniformName);
-  if (uniformAnim == -1) {
-      fprintf(stderr, "Error: could not bind uniform %s\n", uniformName);
-      exit(EXIT_FAILURE);
+  // the same permutation the solver applies to its state
+  for (position = 0; position < 27; position++) {
+      previous[position] = positionArray[position];
+  }
+  for (position = 0; position < 27; position++) {
+      positionArray[position] = previous[positionMoveTable.from[move][position]];
   }
-  glUniformMatrix4fv(uniformAnim, 1, GL_FALSE, glm::value_ptr(anim));
-}
-
-glm::mat4 rotZ(glm::mat4 anim, float orientation, glm::vec3 rot, bool trans, bool fancy, bool lastRound) {
-    float angle = 0.0;
-
-    if (avDeltaTime != 0.0) {
-        angle = 1.0f * avDeltaTime*speed * orientation;
-        if (lastRound) {
-            angle += orientation * degLoss;
-        }
-    } else {
-        deltaTimeError();
-    }
-
-    if(fancy == false) {
-        angle = 90.0f * orientation;
-    }
-    if(trans == true) {
-        anim = glm::translate(anim, glm::vec3(0.0f, 0.0f, -2.1f) );
-        anim = glm::rotate(anim, glm::radians(angle), rot);
-        anim = glm::translate(anim, -(glm::vec3(0.0f, 0.0f, -2.1f)) );
-    } else {
-        anim = glm::rotate(anim, glm::radians(angle), rot);
-    }
-
-    return anim;
-}
-
-glm::mat4 rotX(glm::mat4 anim, float orientation, glm::vec3 axis, bool fancy, bool lastRound) {
-    float angle = 0.0;
-
-    if (avDeltaTime != 0.0) {
-        angle = 1.0f * avDeltaTime*speed * orientation;
-        if (lastRound) {
-            angle += orientation * degLoss;
-        }
-    } else {
-        deltaTimeError();
-    }
-
-    if(fancy == false) {
-        angle = 90.0f * orientation;
-    }
-    anim = glm::translate(anim, glm::vec3(0.0f, 0.0f, -2.1f) );
-    anim = glm::rotate(anim, glm::radians(angle), axis);
-    anim = glm::translate(anim, -(glm::vec3(0.0f, 0.0f, -2.1f)) );
-
-    return anim;
-}
-
-glm::mat4 rotY(glm::mat4 anim, float orientation, glm::vec3 axis, bool fancy, bool lastRound) {
-    float angle = 0.0;
-
-    if (avDeltaTime != 0.0) {
-        angle = 1.0f * avDeltaTime*speed * orientation;
-        if (lastRound) {
-            angle += orientation * degLoss;
-        }
-    } else {
-        deltaTimeError();
-    }
-
-    if(fancy == false) {
-        angle = 90.0f * orientation;
-    }
-    anim = glm::translate(anim, glm::vec3(-2.1f, 0.0f, -4.2f));
-    anim = glm::translate(anim, glm::vec3(2.1f, 0.0f, 2.1f));
-    anim = glm::rotate(anim, glm::radians(angle), axis);
-    anim = glm::translate(anim, -(glm::vec3(2.1f, 0.0f, 2.1f)));
-    anim = glm::translate(anim, -(glm::vec3(-2.1f, 0.0f, -4.2f)));
-
-    return anim;
-}
-
-glm::mat4 spinAllX(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign = 1;
-
-    rot = glm::vec3(1.0f, 0.0f, 0.0f);
-
-    if(orientation == -1.0) {
-
-        rot = calcAxis(i, rot, UP_X);
-
-        sign = getOrientationFromAxis(i, rot, UP_X);
-
-        if(nrRotations >= (limit*27)-27 || fancy == false) {
-            setAxis(i, rot, UP_X);
-            lastRound = true;
-        }
-    } else {
-        rot = calcAxis(i, rot, DOWN_X);
-
-        sign = getOrientationFromAxis(i, rot, DOWN_X);
-
-        if(nrRotations >= (limit*27)-27 || fancy == false) {
-            setAxis(i, rot, DOWN_X);
-            lastRound = true;
-        }
-    }
-    anim = rotX(anim, orientation*sign, rot, fancy, lastRound);
-    lastRound = false;
-
-    if(fancy == true) {
-        nrRotations += 1;
-    } else {
-        nrRotations = limit*27;
-    }
-
-    return anim;
-}
-
-glm::mat4 spinAllZ(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign;
-    bool trans = true;
-
-    rot = glm::vec3(0.0f, 0.0f, 1.0f);
-
-    if(orientation == 1.0) {
-
-        rot = calcAxis(i, rot, LEFT_Z);
-
-        sign = getOrientationFromAxis(i, rot, LEFT_Z);
-
-        if(nrRotations >= (limit*27)-27 || fancy == false) {
-            setAxis(i, rot, LEFT_Z);
-            lastRound = true;
-        }
-
-    } else {
-        rot = calcAxis(i, rot, RIGHT_Z);
-
-        sign = getOrientationFromAxis(i, rot, RIGHT_Z);
-
-        if(nrRotations >= (limit*27)-27 || fancy == false) {
-            setAxis(i,rot, RIGHT_Z);
-            lastRound = true;
-        }
-    }
-
-    if (xAxisArray[i] == AXIS_RIGHT && yAxisArray[i] == AXIS_UP && zAxisArray[i] == AXIS_FRONT) {
-        trans = false;
-    }
-
-    anim = rotZ(anim, orientation*sign, rot, trans, fancy, lastRound);
-    lastRound = false;
-
-    if(fancy == true) {
-        nrRotations +=1;
-    } else {
-      nrRotations = limit*27;
-    }
 
-    return anim;
+  updateLayerMasks();
 }
 
-glm::mat4 spinAllY(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign = 0;
-
-    rot = glm::vec3(0.0f, 1.0f, 0.0f);
-
-    if (orientation == 1.0) { // counter clockwise
-        rot = calcAxis(i, rot, LEFT_Y);
-
-        sign = getOrientationFromAxis(i, rot, LEFT_Y);
-
-        if(nrRotations >= (limit*27)-27 || fancy == false) {
-            setAxis(i, rot, LEFT_Y);
-            lastRound = true;
-        }
+// solution of the cube as shown, ends with -1 like the other move lists of the render loop. Right after a scramble
+// it is the one the scramble task made for it (waiting only if that solve is still running).
+static vector<int> getLiveSolution() {
+    vector<int> solution;
+    double milliseconds;
+
+    if (scramblePlayed && scrambleTask->getState() == liveState) {
+        solution = scrambleTask->getSolution(&milliseconds);
+        cout << "solution: " << solution.size() << " moves (scramble solved in " << milliseconds << " ms): "
+             << toNotation(solution) << endl;
+        scramblePlayed = false;
+        scrambleTask->start();
     } else {
-        rot = calcAxis(i, rot, RIGHT_Y);
-
-        sign = getOrientationFromAxis(i, rot, RIGHT_Y);
-
-        if(nrRotations >= (limit*27)-27 || fancy == false) {
-            setAxis(i, rot, RIGHT_Y);
-            lastRound = true;
-        }
-    }
-
-    anim = rotY(anim, orientation*sign, rot, fancy, lastRound);
-    lastRound = false;
-    if(fancy == true) {
-        nrRotations +=1;
-    } else {
-      nrRotations = limit*27;
+        if (!liveSolver->getSolution(liveState, &solution, true, &milliseconds))
+            solution.clear();
+        cout << "solution: " << solution.size() << " moves (last background solve " << milliseconds << " ms): "
+             << toNotation(solution) << endl;
     }
-
-    return anim;
+    solution.push_back(-1);
+    return solution;
 }
 
-glm::mat4 spinX2(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign = 1;
-
-    //right Row
-    if(i == positionArray[2][0][0] || i == positionArray[2][0][1] || i == positionArray[2][0][2]
-        || i == positionArray[2][1][0] || i == positionArray[2][1][1] || i == positionArray[2][1][2]
-        || i == positionArray[2][2][0] || i == positionArray[2][2][1] || i == positionArray[2][2][2]) {
-
-        rot = glm::vec3(1.0f, 0.0f, 0.0f);
-
-        if(orientation == -1.0) {
-
-            rot = calcAxis(i, rot, UP_X);
-
-            sign = getOrientationFromAxis(i, rot, UP_X);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-                lastRound = true;
-                setAxis(i, rot, UP_X);
-
-            }
-        } else {
-            rot = calcAxis(i, rot, DOWN_X);
-
-            sign = getOrientationFromAxis(i, rot, DOWN_X);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-                lastRound = true;
-                setAxis(i, rot, DOWN_X);
+// animation of cubie i turned by angle degrees around the world axis in front of its orientation. With the last
+// frame of the turn the rotation becomes part of the orientation, snapped so that no rounding errors pile up over the
+// turns.
+static glm::mat4 turnCubie(int i, glm::vec3 axis, float angle, bool last) {
+    glm::mat4 rotation;
+    unsigned row, column;
+
+    rotation = glm::rotate(glm::mat4(1.0f), glm::radians(angle), axis) * orientationArray[i];
+    if (last) {
+        for (column = 0; column < 3; column++) {
+            for (row = 0; row < 3; row++) {
+                rotation[column][row] = glm::round(rotation[column][row]);
             }
         }
-        anim = rotX(anim, orientation*sign, rot, fancy, lastRound);
-        lastRound = false;
-        if(fancy == true) {
-            nrRotations +=1;
-        } else {
-            nrRotations = limit*9;
-        }
+        orientationArray[i] = rotation;
     }
 
-    return anim;
+    return glm::translate(glm::mat4(1.0f), CUBE_CENTER) * rotation * glm::translate(glm::mat4(1.0f), -CUBE_CENTER);
 }
 
-glm::mat4 spinX1(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign;
-
-    if(i == positionArray[1][0][0] || i == positionArray[1][0][1] || i == positionArray[1][0][2]
-        || i == positionArray[1][1][0] || i == positionArray[1][1][1] || i == positionArray[1][1][2]
-        || i == positionArray[1][2][0] || i == positionArray[1][2][1] || i == positionArray[1][2][2]) {
-
-        rot = glm::vec3(1.0f, 0.0f, 0.0f);
-        if(orientation == -1.0) {
-
-            rot = calcAxis(i, rot, UP_X);
-
-            sign = getOrientationFromAxis(i, rot, UP_X);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-                setAxis(i, rot, UP_X);
-                lastRound = true;
-            }
-        } else {
-            rot = calcAxis(i, rot, DOWN_X);
-
-            sign = getOrientationFromAxis(i, rot, DOWN_X);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-                setAxis(i, rot, DOWN_X);
-                lastRound = true;
-            }
-        }
-        anim = rotX(anim, orientation*sign, rot, fancy, lastRound);
-        lastRound = false;
-            // cout << nrRotations << endl;
-        if(fancy == true) {
-            nrRotations +=1;
-        } else {
-          nrRotations = limit*9;
-        }
-    }
-
-    return anim;
-}
-
-glm::mat4 spinX0(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign;
-
-    if(i == positionArray[0][0][0] || i == positionArray[0][0][1] || i == positionArray[0][0][2]
-        || i == positionArray[0][1][0] || i == positionArray[0][1][1] || i == positionArray[0][1][2]
-        || i == positionArray[0][2][0] || i == positionArray[0][2][1] || i == positionArray[0][2][2]) {
-
-        rot = glm::vec3(1.0f, 0.0f, 0.0f);
-        if(orientation == -1.0) {
-
-            rot = calcAxis(i, rot, UP_X);
-
-            sign = getOrientationFromAxis(i, rot, UP_X);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-                setAxis(i, rot, UP_X);
-                lastRound = true;
-            }
-        } else {
-            rot = calcAxis(i, rot, DOWN_X);
-
-            sign = getOrientationFromAxis(i, rot, DOWN_X);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-                setAxis(i, rot, DOWN_X);
-                lastRound = true;
-            }
-        }
-        anim = rotX(anim, orientation*sign, rot, fancy, lastRound);
-        lastRound = false;
-        if(fancy == true) {
-            nrRotations +=1;
-        } else {
-          nrRotations = limit*9;
-        }
-    }
-
-    return anim;
-}
-
-glm::mat4 spinZ0(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign;
-    bool trans = true;
-
-    if(i == positionArray[0][0][0] || i == positionArray[1][0][0] || i == positionArray[2][0][0]
-        || i == positionArray[0][0][1] || i == positionArray[1][0][1] || i == positionArray[2][0][1]
-        || i == positionArray[0][0][2] || i == positionArray[1][0][2] || i == positionArray[2][0][2]) {
-
-        rot = glm::vec3(0.0f, 0.0f, 1.0f);
-
-
-        if(orientation == 1.0) {
-
-            rot = calcAxis(i, rot, LEFT_Z);
-
-            sign = getOrientationFromAxis(i, rot, LEFT_Z);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-               setAxis(i, rot, LEFT_Z);
-               lastRound = true;
-            }
-
-        } else {
-            rot = calcAxis(i, rot, RIGHT_Z);
-
-            sign = getOrientationFromAxis(i, rot, RIGHT_Z);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-               setAxis(i,rot, RIGHT_Z);
-               lastRound = true;
-
-            }
-        }
-
-        if (xAxisArray[i] == AXIS_RIGHT && yAxisArray[i] == AXIS_UP && zAxisArray[i] == AXIS_FRONT) {
-          trans = false;
-        }
-
-        anim = rotZ(anim, orientation*sign, rot, trans, fancy, lastRound);
-        lastRound = false;
-        if(fancy == true) {
-            nrRotations +=1;
-        } else {
-            nrRotations = limit*9;
-        }
-    }
-
-    return anim;
-}
-
-glm::mat4 spinZ1(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign;
-    bool trans = true;
-
-    if(i == positionArray[0][1][0] || i == positionArray[1][1][0] || i == positionArray[2][1][0]
-        || i == positionArray[0][1][1] || i == positionArray[1][1][1] || i == positionArray[2][1][1]
-        || i == positionArray[0][1][2] || i == positionArray[1][1][2] || i == positionArray[2][1][2]) {
-
-        rot = glm::vec3(0.0f, 0.0f, 1.0f);
-
-        if(orientation == 1.0) {
-
-            rot = calcAxis(i, rot, LEFT_Z);
-
-            sign = getOrientationFromAxis(i, rot, LEFT_Z);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-               setAxis(i, rot, LEFT_Z);
-               lastRound = true;
-            }
-
-        } else {
-            rot = calcAxis(i, rot, RIGHT_Z);
-
-            sign = getOrientationFromAxis(i, rot, RIGHT_Z);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-               setAxis(i,rot, RIGHT_Z);
-               lastRound = true;
-            }
-        }
-
-         if (xAxisArray[i] == AXIS_RIGHT && yAxisArray[i] == AXIS_UP && zAxisArray[i] == AXIS_FRONT) {
-          trans = false;
-        }
-
-        anim = rotZ(anim, orientation*sign, rot, trans, fancy, lastRound);
-        lastRound = false;
-
-        if(fancy == true) {
-            nrRotations += 1;
-        } else {
-            nrRotations = limit*9;
-        }
-    }
-
-    return anim;
+/**********************************************************************
+** usage: openGL_demo [-s speed] [-k seed] [-u] [-o output [-r fps]  **
+**                    [-t] [moves]]                                  **
+**   without -o the cube opens in a window and asks for textures     **
+**   -o  headless: renders offscreen (EGL, no display needed) and    **
+**       writes every frame, to a .y4m stream (- for stdout) or to   **
+**       output00000.png, output00001.png, ...                       **
+**   -r  frames per second of the output (default: 30)               **
+**   -t  textured cube                                               **
+**   -s  turn speed, a multiple of one quarter turn in 0.8 seconds   **
+**       (default: 1, +/- in the window double and halve it), 0 for  **
+**       no animation at all: a replay jumps to its end state        **
+**   -k  seed of the scrambles, the same seed scrambles the same way **
+**       (default: a new one every run)                              **
+**   -u  uniformly random states as scrambles (instead of 25 moves), **
+**       'r' turns into them with the inverse of their solution      **
+**   moves  move codes (movetable.h) or notation (R U' F2 M x ...)   **
+**          to replay, default: randomize and solve like 'r' and 's' **
+**********************************************************************/
+
+static void usage() {
+    fprintf(stderr, "usage: openGL_demo [-s speed] [-k seed] [-u] [-o output.y4m|-|prefix [-r fps] [-t] [moves...]]\n");
+    exit(EXIT_FAILURE);
 }
 
-glm::mat4 spinZ2(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign;
-    bool trans = true;
-
-    if(i == positionArray[0][2][0] || i == positionArray[1][2][0] || i == positionArray[2][2][0]
-        || i == positionArray[0][2][1] || i == positionArray[1][2][1] || i == positionArray[2][2][1]
-        || i == positionArray[0][2][2] || i == positionArray[1][2][2] || i == positionArray[2][2][2]) {
-
-        rot = glm::vec3(0.0f, 0.0f, 1.0f);
-
-       if(orientation == 1.0) {
-
-            rot = calcAxis(i, rot, LEFT_Z);
-
-            sign = getOrientationFromAxis(i, rot, LEFT_Z);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-               setAxis(i, rot, LEFT_Z);
-               lastRound = true;
-            }
-
-        } else {
-            rot = calcAxis(i, rot, RIGHT_Z);
-
-            sign = getOrientationFromAxis(i, rot, RIGHT_Z);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-               setAxis(i,rot, RIGHT_Z);
-               lastRound = true;
-            }
-        }
-
-        if (xAxisArray[i] == AXIS_RIGHT && yAxisArray[i] == AXIS_UP && zAxisArray[i] == AXIS_FRONT) {
-          trans = false;
-        }
-        anim = rotZ(anim, orientation*sign, rot, trans, fancy, lastRound);
-        lastRound = false;
-        if(fancy == true) {
-            nrRotations +=1;
-        } else {
-            nrRotations = limit*9;
+int main(int argc, char** argv)
+{
+    bool isTexured = false;
+    bool headless = false;
+    string output;
+    unsigned fps = 30;
+    double speed = 1;
+    uint64_t seed = getTimeSeed();
+    ScrambleMode scrambleMode = SCRAMBLE_MOVES;
+    vector<int> replay;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+            headless = true;
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            fps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            speed = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-u") == 0) {
+            scrambleMode = SCRAMBLE_RANDOM_STATE;
+        } else if (strcmp(argv[i], "-t") == 0) {
+            isTexured = true;
+        } else if (argv[i][0] >= '0' && argv[i][0] <= '9' && atoi(argv[i]) < NR_MOVES) {
+            replay.push_back(atoi(argv[i]));
+        } else if (argv[i][0] == '-' || !parseNotation(argv[i], &replay)) {
+            usage();
         }
     }
-
-    return anim;
-}
-
-glm::mat4 spinY2(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign = 0;
-    if(i == positionArray[0][0][2] || i == positionArray[1][0][2] || i == positionArray[2][0][2]
-        || i == positionArray[0][1][2] || i == positionArray[1][1][2] || i == positionArray[2][1][2]
-        || i == positionArray[0][2][2] || i == positionArray[1][2][2] || i == positionArray[2][2][2]) {
-
-        rot = glm::vec3(0.0f, 1.0f, 0.0f);
-
-        if (orientation == 1.0) { // counter clockwise
-            rot = calcAxis(i, rot, LEFT_Y);
-
-            sign = getOrientationFromAxis(i, rot, LEFT_Y);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-               setAxis(i, rot, LEFT_Y);
-               lastRound = true;
-            }
-        } else {
-           rot = calcAxis(i, rot, RIGHT_Y);
-
-           sign = getOrientationFromAxis(i, rot, RIGHT_Y);
-
-           if(nrRotations >= (limit*9)-9 || fancy == false) {
-              setAxis(i, rot, RIGHT_Y);
-              lastRound = true;
-           }
-        }
-
-        anim = rotY(anim, orientation*sign, rot, fancy, lastRound);
-        lastRound = false;
-        if(fancy == true) {
-            nrRotations +=1;
-        } else {
-            nrRotations = limit*9;
-        }
+    if (fps == 0 || speed < 0 || (!headless && (isTexured || !replay.empty()))) {
+        usage();
     }
 
-    return anim;
-}
-
-glm::mat4 spinY1(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign = 0;
-    if(i == positionArray[0][0][1] || i == positionArray[1][0][1] || i == positionArray[2][0][1]
-        || i == positionArray[0][1][1] || i == positionArray[1][1][1] || i == positionArray[2][1][1]
-        || i == positionArray[0][2][1] || i == positionArray[1][2][1] || i == positionArray[2][2][1]) {
-
-        rot = glm::vec3(0.0f, 1.0f, 0.0f);
-        if (orientation == 1.0) { // counter clockwise
-
-            rot = calcAxis(i, rot, LEFT_Y);
-
-            sign = getOrientationFromAxis(i, rot, LEFT_Y);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-               setAxis(i, rot, LEFT_Y);
-               lastRound = true;
-            }
-        } else {
-         rot = calcAxis(i, rot, RIGHT_Y);
-
-         sign = getOrientationFromAxis(i, rot, RIGHT_Y);
-
-           if(nrRotations >= (limit*9)-9 || fancy == false) {
-              setAxis(i, rot, RIGHT_Y);
-              lastRound = true;
-           }
-        }
-        anim = rotY(anim, orientation*sign, rot, fancy, lastRound);
-        lastRound = false;
-        if(fancy == true) {
-            nrRotations +=1;
-        } else {
-            nrRotations = limit*9;
-        }
+    /* the frames own stdout, messages go with the errors */
+    if (output == "-") {
+        cout.rdbuf(cerr.rdbuf());
     }
 
-    return anim;
-}
-
-glm::mat4 spinY0(glm::mat4 anim, float orientation, int i, bool fancy = true) {
-    glm::vec3 rot;
-    int sign = 0;
+    if (!headless) {
+        cout << "Textured Cube? [y/n]" << endl;
+        char cInput;
+        cin >> cInput ;
 
-    if(i == positionArray[0][0][0] || i == positionArray[1][0][0] || i == positionArray[2][0][0]
-        || i == positionArray[0][1][0] || i == positionArray[1][1][0] || i == positionArray[2][1][0]
-        || i == positionArray[0][2][0] || i == positionArray[1][2][0] || i == positionArray[2][2][0]) {
+        if(cInput == 'y') {
+            isTexured = true;
 
-        rot = glm::vec3(0.0f, 1.0f, 0.0f);
-        if (orientation == 1.0) { // counter clockwise
-            rot = calcAxis(i, rot, LEFT_Y);
-
-            sign = getOrientationFromAxis(i, rot, LEFT_Y);
-
-            if(nrRotations >= (limit*9)-9 || fancy == false) {
-               setAxis(i, rot, LEFT_Y);
-               lastRound = true;
-            }
-        } else {
-         rot = calcAxis(i, rot, RIGHT_Y);
-
-         sign = getOrientationFromAxis(i, rot, RIGHT_Y);
-
-         if(nrRotations >= (limit*9)-9 || fancy == false) {
-            setAxis(i, rot, RIGHT_Y);
-            lastRound = true;
-         }
-        }
-        anim = rotY(anim, orientation*sign, rot, fancy, lastRound);
-        lastRound = false;
-        if(fancy == true) {
-            nrRotations +=1;
-        } else {
-          nrRotations = limit*9;
         }
     }
-
-    return anim;
-}
-
-int main()
-{
-    cout << "Textured Cube? [y/n]" << endl;
-    char cInput;
-    cin >> cInput ;
-    bool isTexured = false;
-
-    if(cInput == 'y') {
-        isTexured = true;
-
-    }
+    chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+    bool firstFrame = true;
 
     /* window dimensions */
     const GLuint WIDTH = 800, HEIGHT = 600;
@@ -1728,32 +586,51 @@ int main()
     /*                                                                        */
     /* initialization and set-up                                              */
     /*                                                                        */
-    /* initialization of GLFW */
-    glfwSetErrorCallback(errorCallback);
-    if (glfwInit() != GL_TRUE) {
-        fprintf(stderr, "Cannot initialize GLFW\n");
-        exit(EXIT_FAILURE);
-    }
+    GLFWwindow* myWindow = NULL;
+    OffscreenContext offscreen;
+    FrameWriter frameWriter;
+    FrameCapture frameCapture;
+
+    if (headless) {
+        /* no window: an offscreen context, the frames go to frameWriter */
+        if (!offscreen.create(WIDTH, HEIGHT) || !frameWriter.open(output, WIDTH, HEIGHT, fps)) {
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        /* initialization of GLFW */
+        glfwSetErrorCallback(errorCallback);
+        if (glfwInit() != GL_TRUE) {
+            fprintf(stderr, "Cannot initialize GLFW\n");
+            exit(EXIT_FAILURE);
+        }
 
-    /* set some GLFW options: we require OpenGL 3.3 (or more recent) context */
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    /* create GFLW window (monitor in windowed mode), do not share resources */
-    GLFWwindow* myWindow = glfwCreateWindow(WIDTH, HEIGHT, "Rubikscube",
-                                            NULL, NULL);
-    if (myWindow == NULL) {
-        fprintf(stderr, "Cannot open GLFW window\n");
-        exit(EXIT_FAILURE);
+        /* set some GLFW options: we require OpenGL 3.3 (or more recent) context */
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        /* create GFLW window (monitor in windowed mode), do not share resources */
+        myWindow = glfwCreateWindow(WIDTH, HEIGHT, "Rubikscube",
+                                                NULL, NULL);
+        if (myWindow == NULL) {
+            fprintf(stderr, "Cannot open GLFW window\n");
+            exit(EXIT_FAILURE);
+        }
+        glfwMakeContextCurrent(myWindow);
     }
-    glfwMakeContextCurrent(myWindow);
 
     /* initialization of GLEW */
     glewExperimental = GL_TRUE;
     GLenum glewStatus = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    /* GLEW 2 built for GLX loads the GL functions first and only then fails to find an X display, which an EGL
+       context does not have */
+    if (headless && glewStatus == GLEW_ERROR_NO_GLX_DISPLAY) {
+        glewStatus = GLEW_OK;
+    }
+#endif
     if (glewStatus != GLEW_OK) {
         fprintf(stderr, "Error: %s\n", glewGetErrorString(glewStatus));
         exit(EXIT_FAILURE);
@@ -1764,6 +641,10 @@ int main()
         exit(EXIT_FAILURE);
     }
 
+    if (headless && (!offscreen.createFramebuffer() || !frameCapture.open(&frameWriter, WIDTH, HEIGHT))) {
+        exit(EXIT_FAILURE);
+    }
+
     int arraySize = 27;
 
     static Cube colCube[] ={
@@ -1826,56 +707,133 @@ int main()
         TexCube(BOTTOM_RIGHT, -4.2f),
     };
 
-    GLuint myVAO[arraySize];
-    glGenVertexArrays(arraySize, &myVAO[0]);
-
-    /* generate and bind one Vertex Buffer Object */
-    GLuint myVBO[arraySize];
-    glGenBuffers(arraySize, &myVBO[0]);
+    /* one cubie mesh for all 27 instances: the cubies differ only by their offset, the colors (texture coordinates) of
+       their faces and the animation, which are per instance attributes. Instance 27 is the body, a dark box filling
+       the gaps between the cubies. Each face of the mesh is drawn instanced on its own, over the instances that show
+       it (see buildFaceInstances), so the inward faces cost nothing unless a turn uncovers them */
+    GLuint myVAO;
+    glGenVertexArrays(1, &myVAO);
+    glBindVertexArray(myVAO);
 
-    /* copy the vertex data to it */
+    /* generate three Buffer Objects: mesh, indices, face instances */
+    GLuint myVBO[3];
+    glGenBuffers(3, &myVBO[0]);
 
     int vtxSize = 5;
     for(int i = 0; i < arraySize; i++) {
         if(!isTexured) {
             vtxSize = 6;
             vtxArray[i] = colCube[i].createCubes();
-
-            glBindVertexArray(myVAO[i]);
-            glBindBuffer(GL_ARRAY_BUFFER, myVBO[i]);
-            glBufferData(GL_ARRAY_BUFFER, vtxArray[i].size()*4, &vtxArray[i], GL_STATIC_DRAW);
         } else if (isTexured) {
             vtxArrayTex[i] = texCube[i].createCubes();
+        }
+    }
 
-            glBindVertexArray(myVAO[i]);
-            glBindBuffer(GL_ARRAY_BUFFER, myVBO[i]);
-            glBufferData(GL_ARRAY_BUFFER, vtxArrayTex[i].size()*4, &vtxArrayTex[i], GL_STATIC_DRAW);
+    /* copy the vertex data to it: the 4 corners (position and texture coordinates) of every face of cubie 0, the
+       indices keep the winding of createCubes, face f is the range from f*6 on */
+    array<GLfloat,5*CUBIE_VERTICES> meshArray;
+    array<GLushort,36> indexArray;
+    int corners = 0;
+    for(int f = 0; f < 6; f++) {
+        int first = corners;
+        for(int v = f*6; v < f*6 + 6; v++) {
+            const GLfloat* vtx = isTexured ? &vtxArrayTex[0][v*vtxSize] : &vtxArray[0][v*vtxSize];
+            int c = first;
+            while(c < corners && (meshArray[c*5] != vtx[0] || meshArray[c*5 + 1] != vtx[1] || meshArray[c*5 + 2] != vtx[2])) {
+                c++;
+            }
+            if(c == corners) {
+                meshArray[c*5] = vtx[0];
+                meshArray[c*5 + 1] = vtx[1];
+                meshArray[c*5 + 2] = vtx[2];
+                meshArray[c*5 + 3] = isTexured ? vtx[3] : 0.0f;
+                meshArray[c*5 + 4] = isTexured ? vtx[4] : 0.0f;
+                corners++;
+            }
+            indexArray[v] = c;
         }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, myVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, meshArray.size()*sizeof(GLfloat), &meshArray[0], GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), 0);
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vtxSize * sizeof(GLfloat), 0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*) (3 * sizeof(GLfloat)));
 
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, vtxSize - 3, GL_FLOAT, GL_FALSE, vtxSize * sizeof(GLfloat), (void*) (3 * sizeof(GLfloat)));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, myVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexArray.size()*sizeof(GLushort), &indexArray[0], GL_STATIC_DRAW);
+
+    /* per cubie: offset to cubie 0 and scale, then per face the color or the texture coordinate offset and shade */
+    array<GLfloat,INSTANCE_SIZE*NR_CUBIES> instanceArray;
+    array<GLuint,27> outwardFaceArray;
+    for(int i = 0; i < arraySize; i++) {
+        const GLfloat* vtx = isTexured ? &vtxArrayTex[i][0] : &vtxArray[i][0];
+        const GLfloat* vtx0 = isTexured ? &vtxArrayTex[0][0] : &vtxArray[0][0];
+        for(int c = 0; c < 3; c++) {
+            instanceArray[i*INSTANCE_SIZE + c] = vtx[c] - vtx0[c];
+        }
+        instanceArray[i*INSTANCE_SIZE + 3] = 1.0f;
+        for(int f = 0; f < 6; f++) {
+            int v = f*6*vtxSize;
+            if(!isTexured) {
+                instanceArray[i*INSTANCE_SIZE + 4 + f*3] = vtx[v + 3];
+                instanceArray[i*INSTANCE_SIZE + 5 + f*3] = vtx[v + 4];
+                instanceArray[i*INSTANCE_SIZE + 6 + f*3] = vtx[v + 5];
+            } else {
+                instanceArray[i*INSTANCE_SIZE + 4 + f*3] = vtx[v + 3] - vtx0[v + 3];
+                instanceArray[i*INSTANCE_SIZE + 5 + f*3] = vtx[v + 4] - vtx0[v + 4];
+                instanceArray[i*INSTANCE_SIZE + 6 + f*3] = 1.0f;
+            }
+        }
+        outwardFaceArray[i] = colCube[i].getOutwardFaces();
+    }
+    /* the body: just inside the outer faces of the cubies (which lie 3.1 from the center) */
+    instanceArray[27*INSTANCE_SIZE] = CUBE_CENTER.x;
+    instanceArray[27*INSTANCE_SIZE + 1] = CUBE_CENTER.y;
+    instanceArray[27*INSTANCE_SIZE + 2] = CUBE_CENTER.z;
+    instanceArray[27*INSTANCE_SIZE + 3] = 3.05f;
+    for(int f = 0; f < 6; f++) {
+        instanceArray[27*INSTANCE_SIZE + 4 + f*3] = isTexured ? 0.0f : 0.25f;
+        instanceArray[27*INSTANCE_SIZE + 5 + f*3] = isTexured ? 0.0f : 0.25f;
+        instanceArray[27*INSTANCE_SIZE + 6 + f*3] = isTexured ? 0.1f : 0.25f;
     }
 
+    /* the face instances, rebuilt every frame with the animations: at most every face of every instance (a mat4
+       attribute takes four locations) */
+    static array<GLfloat,FACE_INSTANCE_SIZE*6*NR_CUBIES> faceInstanceArray;
+    GLsizei faceInstanceCounts[6];
+
+    glBindBuffer(GL_ARRAY_BUFFER, myVBO[2]);
+    glBufferData(GL_ARRAY_BUFFER, faceInstanceArray.size()*sizeof(GLfloat), NULL, GL_STREAM_DRAW);
+
+    for(int a = 2; a < 8; a++) {
+        glEnableVertexAttribArray(a);
+        glVertexAttribDivisor(a, 1);
+    }
+    setFaceInstances(0);
+
     /* OpenGL settings */
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     /* define and compile the vertex shader */
     const char* vertexShaderSource = GLSL(
     layout(location=0) in vec3 position;
-    layout(location=1) in vec3 colorVtxIn;
+    layout(location=2) in mat4 anim;
+    layout(location=6) in vec4 offset;
+    layout(location=7) in vec3 face;
     uniform mat4 proj;
     uniform mat4 view;
-    uniform mat4 anim;
     out vec3 colorVtxOut;
     void main() {
-        colorVtxOut = colorVtxIn;
-        gl_Position = proj * view * anim * vec4(position, 1.0);
+        colorVtxOut = face;
+        gl_Position = proj * view * anim * vec4(position * offset.w + offset.xyz, 1.0);
     });
 
     if(isTexured) {
@@ -1883,14 +841,19 @@ int main()
         vertexShaderSource = GLSL(
         layout(location=0) in vec3 position;
         layout(location=1) in vec2 textureCoordIn;
+        layout(location=2) in mat4 anim;
+        layout(location=6) in vec4 offset;
+        layout(location=7) in vec3 face;
         uniform mat4 proj;
         uniform mat4 view;
-        uniform mat4 anim;
         out vec2 textureCoordOut;
+        out float shadeOut;
         void main() {
-            textureCoordOut = vec2(textureCoordIn.x,
-                                1.0 - textureCoordIn.y);
-            gl_Position = proj * view * anim * vec4(position, 1.0);
+            vec2 textureCoord = textureCoordIn + face.xy;
+            textureCoordOut = vec2(textureCoord.x,
+                                1.0 - textureCoord.y);
+            shadeOut = face.z;
+            gl_Position = proj * view * anim * vec4(position * offset.w + offset.xyz, 1.0);
         });
     }
 
@@ -1915,10 +878,11 @@ int main()
     if(isTexured) {
         fragmentShaderSource = GLSL(
         in vec2 textureCoordOut;
+        in float shadeOut;
         out vec4 outColor;
         uniform sampler2D textureData;
         void main() {
-            outColor = texture(textureData, textureCoordOut);
+            outColor = texture(textureData, textureCoordOut) * vec4(shadeOut, shadeOut, shadeOut, 1.0);
         });
     }
 
@@ -1958,7 +922,7 @@ int main()
     }
 
     if (!isTexured){
-        attributeName = "colorVtxIn";
+        attributeName = "face";
         GLint colAttrib = glGetAttribLocation(shaderProgram, attributeName);
         if (colAttrib == -1) {
             fprintf(stderr, "Error: could not bind attribute %s\n", attributeName);
@@ -2000,8 +964,8 @@ int main()
 
     /* define a view transformation */
 
-    GLfloat lastTime = 0;
-    GLfloat currentTime = 0;
+    double lastTime = 0;
+    double currentTime = 0;
 
 
     glm::mat4 view = glm::lookAt(position,
@@ -2043,20 +1007,21 @@ int main()
     glUniformMatrix4fv(uniformProj, 1, GL_FALSE, glm::value_ptr(proj));
 
     /* register callback functions */
-    glfwSetKeyCallback(myWindow, keyCallback);
-    glfwSetCursorPosCallback(myWindow, cursorPosCallBack);
-    glfwSetMouseButtonCallback(myWindow, mouseButtonCallBack);
-    glfwSetScrollCallback(myWindow, scrollCallback);
+    if (!headless) {
+        glfwSetKeyCallback(myWindow, keyCallback);
+        glfwSetCursorPosCallback(myWindow, cursorPosCallBack);
+        glfwSetMouseButtonCallback(myWindow, mouseButtonCallBack);
+        glfwSetScrollCallback(myWindow, scrollCallback);
+    }
 
     /*                                                                        */
     /* event-handling and rendering loop                                      */
     /*                                                                        */
 
-    glm::mat4 myAnim;
-    nrRotations = 0;
+    animationClock.setSpeed(speed);
 
     int move = -1;
-    array<glm::mat4,27> animArray;
+    array<glm::mat4,NR_CUBIES> animArray;
 
     for(int i = 0; i < (int) animArray.size(); i++) {
         animArray[i] = anim;
@@ -2064,23 +1029,60 @@ int main()
 
     int vecCounter = 0;
 
+    // the current turn: its moves and the cubies they turn
+    int group[3];
+    unsigned groupSize = 0;
+    uint32_t turning = 0;
+
+    // replay throughput, counted from the first animated move of a move list to its end
+    unsigned replayedMoves = 0;
+    chrono::steady_clock::time_point replayStart;
+
     initPositionArray();
-    initAxisArray();
+    updateLayerMasks();
+    initOrientationArray();
+
+    // scramble and solve in the background, the first frame does not wait for either
+    scrambleTask = new ScrambleTask(seed, scrambleMode);
+    scrambleTask->start();
 
-    AlgoCube algoCube = AlgoCube();
-    algoCube.initCube();
-    algoCube.createRandomCube();
-    algoCube.solveRubiksCube();
-    vector<int> randomizer = algoCube.getRandomizeCubeMoves();
-    vector<int> solverMoves = algoCube.getMoves();
-    solverMoves.push_back(-1);
+    // solves every state the cube passes through, 's' then only picks up the solution
+    liveState.reset();
+    liveSolver = new BackgroundSolver();
 
     vector<int> moves = {-1};
 
-    cout << "randomizer: " << randomizer.size() << endl;
-    cout << "solver: " << solverMoves.size() << endl;
+    if (headless) {
+        /* the replay starts at once and ends the loop when done, the camera looks at three sides from the first frame
+           on */
+        position = glm::vec3(4.0f, 4.0f, 6.0f);
+        view = glm::lookAt(position, glm::vec3(0.0f, 0.0f, -2.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glUniformMatrix4fv(uniformView, 1, GL_FALSE, glm::value_ptr(view));
+        r_clicked = true;
+        s_clicked = true;
+        solver = false;
+        if (!replay.empty()) {
+            moves = replay;
+            solver = true;
+        }
+    }
+
+    if (!headless) {
+        lastTime = glfwGetTime();
+    }
+
+    while (headless ? r_clicked : !glfwWindowShouldClose(myWindow)) {
 
-    while (!glfwWindowShouldClose(myWindow)) {
+        if (r_clicked == false && s_clicked == true && move == -1) {
+            moves = getLiveSolution();
+            vecCounter = 0;
+            if (moves.at(0) == -1) {
+                s_clicked = false;
+            } else {
+                solver = true;
+                r_clicked = true;
+            }
+        }
 
         if (r_clicked == false) {
           if (key_row != -1 && key_axis != -1) {
@@ -2097,164 +1099,157 @@ int main()
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        if (r_clicked == true) {
-          if (move == -1 && moves.at(0) == -1)
-            moves = randomizer;
-        }
-        if (moves.at(0) != -1 && r_clicked == true) {
-          if (vecCounter < (int) moves.size()) {
-              move = moves.at(vecCounter);
-          }
-          else if(vecCounter == (int)moves.size()) {
-              if(solver == false && s_clicked == true) {
-                  moves = solverMoves;
-                  vecCounter = 0;
-                  solver = true;
+        /* while the clock is a whole turn ahead, a move list goes on with the next turn in the same frame */
+        for (;;) {
+            if (r_clicked == true) {
+              if (move == -1 && moves.at(0) == -1) {
+                // a scramble played without 's' is used up, the next one is made meanwhile
+                if (scramblePlayed)
+                  scrambleTask->start();
+                moves = scrambleTask->getScramble();
+                scramblePlayed = true;
+                cout << "scramble: " << moves.size() << " moves: " << toNotation(moves) << endl;
+              }
+            }
+            if (moves.at(0) != -1 && r_clicked == true) {
+              if (vecCounter < (int) moves.size()) {
                   move = moves.at(vecCounter);
-              } else if(solver == false && s_clicked == false){
-                  move = -1;
-              } else {
-                  move = -1;
-                  vecCounter++;
               }
-          }
-        }
+              else if(vecCounter == (int)moves.size()) {
+                  if(solver == false && s_clicked == true) {
+                      moves = getLiveSolution();
+                      vecCounter = 0;
+                      solver = true;
+                      move = moves.at(vecCounter);
+                  } else if(solver == false && s_clicked == false){
+                      move = -1;
+                  } else {
+                      move = -1;
+                      vecCounter++;
+                  }
+              }
+            }
 
-        for(int i = 0; i < arraySize; i+=1) {  //TODO: Cube Array aufteilen mit veränderte und unveränderte Cubes IDEE!
-            glBindVertexArray(myVAO[i]);
-
-            myAnim = animArray[i];
-
-            rotating = true;
-
-            if(move == 0) {
-                myAnim = spinAllX(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 1) {
-                myAnim = spinAllX(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 2) {
-                myAnim = spinAllZ(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 3) {
-                myAnim = spinAllZ(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 4) {
-                myAnim = spinAllY(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 5) {
-               myAnim = spinAllY(myAnim, 1.0, i, solver);
-               animArray[i] = myAnim;
-            } else if(move == 6) {
-                myAnim = spinX0(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 7) {
-                myAnim = spinX1(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 8) {
-                myAnim = spinX2(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 9) {
-                myAnim = spinX0(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 10) {
-                myAnim = spinX1(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 11) {
-                myAnim = spinX2(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 12) {
-                myAnim = spinZ0(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 13) {
-                myAnim = spinZ1(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 14) {
-                myAnim = spinZ2(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 15) {
-                myAnim = spinZ0(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 16) {
-                myAnim = spinZ1(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 17) {
-                myAnim = spinZ2(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 18) {
-                myAnim = spinY0(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 19) {
-                myAnim = spinY1(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 20) {
-                myAnim = spinY2(myAnim, -1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 21) {
-                myAnim = spinY0(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 22) {
-                myAnim = spinY1(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else if(move == 23) {
-                myAnim = spinY2(myAnim, 1.0, i, solver);
-                animArray[i] = myAnim;
-            } else {
-              rotating = false;
-              if (s_clicked == true) {
+            /* animated move lists turn parallel layers together, the others keep their last animation */
+            groupSize = 0;
+            if (move != -1 && r_clicked == true && solver == true) {
+                groupSize = getTurnGroup(moves, vecCounter, group);
+            } else if (move != -1) {
+                group[groupSize++] = move;
+            }
+            turning = 0;
+            for (unsigned g = 0; g < groupSize; g++) {
+                turning |= getTurningCubies(group[g]);
+            }
+            rotating = turning != 0;
+
+            if (turning == 0 && replayedMoves > 0) {
+                double seconds = chrono::duration<double>(chrono::steady_clock::now() - replayStart).count();
+                cout << "replay: " << replayedMoves << " moves in " << seconds << " s ("
+                     << (seconds > 0 ? replayedMoves / seconds : 0) << " moves/s)" << endl;
+                replayedMoves = 0;
+            }
+            if (turning == 0 && s_clicked == true) {
                 r_clicked = false;
                 s_clicked = false;
-              }
+                moves = {-1};
+                vecCounter = 0;
             }
 
-            glUniformMatrix4fv(uniformAnim, 1, GL_FALSE, glm::value_ptr(myAnim));
-            glDrawArrays(GL_TRIANGLES, 0, 6*36);
-        }
+            /* the angle follows the clock, the moves of an 'r' scramble (solver is false) end at once, key turns and
+               solutions are animated */
+            bool turnDone = false;
+            if (turning != 0) {
+                if (!animationClock.isTurning()) {
+                    animationClock.startTurn();
+                    if (replayedMoves == 0 && r_clicked == true && solver == true) {
+                        replayStart = chrono::steady_clock::now();
+                    }
+                }
+                turnDone = !solver || animationClock.isTurnDone();
+            }
+            float angle = turnDone ? 90.0f : 90.0f * animationClock.getProgress();
+
+            for (unsigned g = 0; g < groupSize; g++) {
+                uint32_t layer = getTurningCubies(group[g]);
+
+                for(int i = 0; layer >> i != 0; i+=1) {
+                    if ((layer & (1u << i)) == 0) {
+                        continue;
+                    }
+
+                    // forward moves turn by -90 degrees around the world axis
+                    animArray[i] = turnCubie(i, turnAxisArray[moveAxis(group[g])],
+                                             isReverseMove(group[g]) ? angle : -angle, turnDone);
+                }
+            }
 
-        if(move == 0 || move == 1 || move == 2 || move == 3 || move == 4 || move == 5) {
-            if(nrRotations == limit*27) {
-                changeCubePositions(move);
-                nrRotations = 0;
-                vecCounter += 1;
-                if (vecCounter % 10 == 0)
-                    cout << "cnt: " << vecCounter << endl;
-                key_row = -1;
-                key_axis = -1;
-                move = -1;
-                rotating = false;
+            if (move == -1 || !turnDone) {
+                break;
             }
-        } else {
-            if(nrRotations == limit*9) {
-                changeCubePositions(move);
-                nrRotations = 0;
-                vecCounter += 1;
-                if (vecCounter % 10 == 0)
-                    cout << "cnt: " << vecCounter << endl;
-                key_row = -1;
-                key_axis = -1;
-                move = -1;
-                rotating = false;
+
+            for (unsigned g = 0; g < groupSize; g++) {
+                changeCubePositions(group[g]);
+            }
+            animationClock.endTurn();
+            if (r_clicked == true && solver == true) {
+                replayedMoves += groupSize;
+            }
+            vecCounter += groupSize;
+            if (vecCounter / 10 != (vecCounter - (int) groupSize) / 10)
+                cout << "cnt: " << vecCounter << endl;
+            key_row = -1;
+            key_axis = -1;
+            move = -1;
+            rotating = false;
+
+            if (r_clicked == false || !animationClock.isAhead()) {
+                break;
             }
         }
 
-        currentTime = glfwGetTime();
-        deltaTime = GLfloat(currentTime - lastTime);
-        lastTime = currentTime;
-        avCounter--;
-        if (avCounter > 0 && avCounter < 21) {
-            avDeltaTime += deltaTime;
-        } else if(avCounter == 0){
-            calcAvDeltaTimeAndLimit();
-            cout << "Average Delta Time: " << avDeltaTime << endl;
+        /* every face in one instanced draw over the cubies that show it, the animations go in with the instances */
+        uint32_t openCubies = rotating ? getOpenCubies(group, groupSize) : 0;
+        glBindVertexArray(myVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, myVBO[2]);
+        GLsizei faceInstances = buildFaceInstances(openCubies, &outwardFaceArray[0], &animArray[0], &instanceArray[0],
+                                                   &faceInstanceArray[0], faceInstanceCounts);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, faceInstances*FACE_INSTANCE_SIZE*sizeof(GLfloat), &faceInstanceArray[0]);
+        for (int f = 0, first = 0; f < 6; first += faceInstanceCounts[f++]) {
+            setFaceInstances(first);
+            glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, (void*) (f*6*sizeof(GLushort)),
+                                    faceInstanceCounts[f]);
+        }
+        if (firstFrame) {
+            cout << "first frame after " << chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count()
+                 << " ms" << endl;
+            firstFrame = false;
         }
 
-        lookAtCallBack(myWindow);
+        /* offscreen every frame is one step of the frame rate, in the window the time it really took */
+        if (headless) {
+            animationClock.advance(1000.0 / fps);
+        } else {
+            currentTime = glfwGetTime();
+            animationClock.advance((currentTime - lastTime) * 1000.0);
+            lastTime = currentTime;
+
+            lookAtCallBack(myWindow);
+        }
         view = glm::lookAt(position, glm::vec3(0.0f, 0.0f, -2.0f), glm::vec3(0.0f, 1.0f, 0.0f));
         glUniformMatrix4fv(uniformView, 1, GL_FALSE, glm::value_ptr(view));
 
         proj = glm::perspective(glm::radians(fov), 4.0f/3.0f, 0.1f, 40.0f);
         glUniformMatrix4fv(uniformProj, 1, GL_FALSE, glm::value_ptr(proj));
 
+        if (headless) {
+            /* the frame drawn above, read back asynchronously and written by the capture thread */
+            if (!frameCapture.capture()) {
+                exit(EXIT_FAILURE);
+            }
+            continue;
+        }
+
         /* Swap buffers */
         glfwSwapBuffers(myWindow);
 
@@ -2262,6 +1257,14 @@ int main()
         glfwPollEvents();
     }
 
+    if (headless) {
+        if (!frameCapture.finish()) {
+            exit(EXIT_FAILURE);
+        }
+        fprintf(stderr, "%llu frames written to %s (%.1f fps)\n", (unsigned long long) frameCapture.getFrames(),
+                output.c_str(), frameCapture.getFramesPerSecond());
+    }
+
     /*                                                                        */
     /* clean-up and release resources                                         */
     /*                                                                        */
@@ -2273,18 +1276,24 @@ int main()
     glDeleteShader(vertexShader);
     glDeleteProgram(shaderProgram);
 
-    for(int i = 0; i < 5; i+=1) {
-        glDeleteBuffers(arraySize,myVBO);
-
-        glDeleteVertexArrays(arraySize, myVAO);
-    }
+    glDeleteBuffers(3, myVBO);
+    glDeleteVertexArrays(1, &myVAO);
 
 
 
     /*                                                                        */
     /* termination of GLFW                                                    */
     /*                                                                        */
-    glfwTerminate();
+    if (headless) {
+        frameWriter.close();
+        offscreen.destroy();
+    } else {
+        glfwTerminate();
+    }
 
+    delete scrambleTask;
+    scrambleTask = NULL;
+    delete liveSolver;
+    liveSolver = NULL;
     exit(EXIT_SUCCESS);
 }
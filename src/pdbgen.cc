@@ -0,0 +1,103 @@
+/* standard includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <chrono>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "rubikscube/patterndb.h"
+#include "rubikscube/twophase.h"
+#include "rubikscube/optimal.h"
+
+using namespace std;
+
+/**********************************************************************
+** pdbgen -- writes the pattern files of the table based solvers     **
+**                                                                   **
+** usage: pdbgen [-j threads] [-s twophase|optimal|all] [-v] [dir]   **
+**   -j  threads of the breadth first searches (default: all cpus)   **
+**   -s  solver whose tables are written (default: all)              **
+**   -v  only check the checksums of the files already in dir        **
+**   dir output directory (default: RUBIKSCUBE_PDB_DIR or pdb)       **
+**********************************************************************/
+
+static void usage() {
+    fprintf(stderr, "usage: pdbgen [-j threads] [-s twophase|optimal|all] [-v] [directory]\n");
+    exit(EXIT_FAILURE);
+}
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// returns the number of files of solver that are missing or damaged
+static unsigned verifyFiles(const string& directory, const string& solver) {
+    const unsigned kinds[] = {CORNER_PATTERNS, EDGE_PATTERNS_0, EDGE_PATTERNS_1, PHASE1_SLICE_TWIST,
+                              PHASE1_SLICE_FLIP, PHASE2_CORNER_PERM, PHASE2_EDGE_PERM};
+    const uint64_t entries[] = {NR_CORNER_PATTERNS, NR_EDGE_SUBSETS, NR_EDGE_SUBSETS, NR_SLICES * NR_TWISTS,
+                                NR_SLICES * NR_FLIPS, NR_PERMS * NR_SLICE_PERMS, NR_PERMS * NR_SLICE_PERMS};
+    const unsigned bits[] = {4, 4, 4, 8, 8, 8, 8};
+    unsigned failed = 0, i;
+
+    for (i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+        if (solver != "all" && solver != (kinds[i] <= EDGE_PATTERNS_1 ? "optimal" : "twophase"))
+            continue;
+        PatternTable table;
+        string path = getPatternPath(directory, kinds[i]);
+        bool ok = table.load(path, kinds[i], entries[i], bits[i]) && table.verify();
+        printf("%-28s %s\n", path.c_str(), ok ? "ok" : "missing or damaged");
+        failed += !ok;
+    }
+    return failed;
+}
+
+int main(int argc, char** argv) {
+    string directory = getPatternDirectory();
+    string solver = "all";
+    unsigned nrThreads = 0;
+    bool verifyOnly = false;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            nrThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            solver = argv[++i];
+        else if (strcmp(argv[i], "-v") == 0)
+            verifyOnly = true;
+        else if (argv[i][0] == '-')
+            usage();
+        else
+            directory = argv[i];
+    }
+    if (solver != "all" && solver != "twophase" && solver != "optimal")
+        usage();
+
+    if (verifyOnly)
+        return verifyFiles(directory, solver) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    mkdir(directory.c_str(), 0755);
+
+    if (solver == "all" || solver == "twophase") {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        TwoPhaseSolver twoPhase("", nrThreads);
+        printf("two-phase tables built in %.1f s\n", secondsSince(start));
+        if (!twoPhase.saveTables(directory)) {
+            fprintf(stderr, "could not write the two-phase tables to %s\n", directory.c_str());
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (solver == "all" || solver == "optimal") {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        OptimalSolver optimal("", nrThreads);
+        printf("pattern databases built in %.1f s\n", secondsSince(start));
+        if (!optimal.saveTables(directory)) {
+            fprintf(stderr, "could not write the pattern databases to %s\n", directory.c_str());
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return verifyFiles(directory, solver) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,78 @@
+/* standard includes */
+#include "animationclock.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+AnimationClock::AnimationClock() {
+    now = 0;
+    speed = 1;
+    turnStart = 0;
+    nextStart = 0;
+    turning = false;
+    idleFrames = 2;
+}
+
+void AnimationClock::advance(double milliseconds) {
+    if (!turning && idleFrames < 2)
+        idleFrames++;
+    if (milliseconds > 0)
+        now += milliseconds;
+}
+
+// keeps the progress of a running turn, only the rest of it goes faster or slower
+void AnimationClock::setSpeed(double speed) {
+    float progress = getProgress();
+
+    if (speed <= 0 || speed > MAX_TURN_SPEED)
+        speed = 0;
+    else if (speed < MIN_TURN_SPEED)
+        speed = MIN_TURN_SPEED;
+    this->speed = speed;
+    if (turning)
+        turnStart = now - progress * getTurnMilliseconds();
+}
+
+// right after the last turn (in the frame it ended in or the next) the new one continues from its end, after a
+// frame without a turn it starts now
+void AnimationClock::startTurn() {
+    turnStart = idleFrames < 2 ? nextStart : now;
+    turning = true;
+}
+
+// a microsecond of slack, fixed steps like 1000/30 ms do not add up exactly
+bool AnimationClock::isTurnDone() const {
+    return turning && now - turnStart >= getTurnMilliseconds() - 0.001;
+}
+
+// share of the current turn already shown, 0 to 1
+float AnimationClock::getProgress() const {
+    double progress;
+
+    if (!turning)
+        return 0;
+    if (speed == 0)
+        return 1;
+    progress = (now - turnStart) / getTurnMilliseconds();
+    if (progress < 0)
+        return 0;
+    return progress > 1 ? 1 : progress;
+}
+
+// turns ended early (without animation) do not push the next one into the future
+void AnimationClock::endTurn() {
+    nextStart = turnStart + getTurnMilliseconds();
+    if (nextStart > now)
+        nextStart = now;
+    turning = false;
+    idleFrames = 0;
+}
+
+// in the frame a turn ended: the next one would be over by now as well
+bool AnimationClock::isAhead() const {
+    return !turning && idleFrames == 0 && now - nextStart >= getTurnMilliseconds() - 0.001;
+}
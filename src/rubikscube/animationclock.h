@@ -0,0 +1,49 @@
+// header file for animationclock.cc
+
+#ifndef ANIMATIONCLOCK_H
+#define ANIMATIONCLOCK_H
+
+using namespace std;
+
+const double TURN_MILLISECONDS = 800.0;    // one quarter turn at speed 1
+const double MIN_TURN_SPEED = 0.125;
+const double MAX_TURN_SPEED = 1024.0;   // above it (or at 0) turns take no time at all
+
+class AnimationClock {
+private:
+    /***************************************************************
+    ** Time base of the turn animation. The render loop advances  **
+    ** it by the time of each frame (measured in the window, a    **
+    ** fixed step per frame when rendering offscreen) and every   **
+    ** turn takes TURN_MILLISECONDS / speed of that time, however **
+    ** many frames it gets. A turn following right after another  **
+    ** starts where the last one ended, so long sequences keep    **
+    ** their pace instead of losing the rest of a frame per turn. **
+    ** When the clock is a whole turn ahead after a turn, the     **
+    ** loop can apply the next one at once (several per frame).   **
+    ***************************************************************/
+    double now;                 // milliseconds
+    double speed;               // 0 for unbounded
+    double turnStart;
+    double nextStart;           // end of the last turn
+    bool turning;
+    unsigned idleFrames;        // frames advanced since the last turn ended
+
+public:
+    AnimationClock();
+
+    void advance(double milliseconds);
+    void setSpeed(double speed);
+    double getSpeed() const { return speed; }
+    bool isUnbounded() const { return speed == 0; }
+    double getTurnMilliseconds() const { return speed == 0 ? 0 : TURN_MILLISECONDS / speed; }
+
+    void startTurn();
+    bool isTurning() const { return turning; }
+    bool isTurnDone() const;
+    float getProgress() const;
+    void endTurn();
+    bool isAhead() const;
+};
+
+#endif
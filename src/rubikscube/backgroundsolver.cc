@@ -0,0 +1,124 @@
+/* standard includes */
+#include <stdint.h>
+#include <vector>
+#include <chrono>
+#include "backgroundsolver.h"
+#include "movetable.h"
+#include "twophase.h"
+#include "moveoptimizer.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+// starts at the solved cube, the worker sets up the solver tables first
+BackgroundSolver::BackgroundSolver(unsigned timeLimitMs) {
+    currentValid = true;
+    currentVersion = 0;
+    solvedVersion = 0;
+    solveMilliseconds = 0;
+    this->timeLimitMs = timeLimitMs;
+    stopping = false;
+    worker = thread(&BackgroundSolver::run, this);
+}
+
+BackgroundSolver::~BackgroundSolver() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+void BackgroundSolver::run() {
+    const TwoPhaseSolver& twoPhase = TwoPhaseSolver::getInstance();
+    CubeState state;
+    vector<int> moves;
+    uint64_t version;
+    bool valid;
+
+    for (;;) {
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait(guard, [this]() { return stopping || currentVersion != solvedVersion; });
+            if (stopping)
+                return;
+            state = currentState;
+            version = currentVersion;
+        }
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        moves.clear();
+        valid = twoPhase.solve(state, &moves, 20, timeLimitMs);
+        optimizeMoves(&moves);
+
+        {
+            lock_guard<mutex> guard(lock);
+            // the cube may have moved on meanwhile, then this solution is of no use
+            if (version == currentVersion && valid && (!currentValid || moves.size() < currentSolution.size())) {
+                currentSolution.swap(moves);
+                currentValid = true;
+            }
+            if (version == currentVersion)
+                solvedVersion = version;
+            solveMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        }
+        solved.notify_all();
+    }
+}
+
+// state after move (the move that turned the previous state into state, -1 if unknown). Cheap enough to call after
+// every move: a known move only extends the current solution.
+void BackgroundSolver::update(const CubeState& state, int move) {
+    {
+        lock_guard<mutex> guard(lock);
+        CubeState next = currentState;
+
+        if (state == currentState)
+            return;
+        if (move >= 0 && move < NR_MOVES)
+            next.applyMove(move);
+        if (currentValid && move >= 0 && move < NR_MOVES && next == state) {
+            currentSolution.insert(currentSolution.begin(), inverseMove(move));
+            optimizeMoves(&currentSolution);
+        } else {
+            currentSolution.clear();
+            currentValid = false;
+        }
+        currentState = state;
+        currentVersion++;
+    }
+    changed.notify_one();
+}
+
+// copies the solution of state into moves. Without wait it returns false if there is none yet, with wait it posts state
+// if needed and blocks until the worker solved it. Also false if state cannot be solved. milliseconds is the time of
+// the last solve of the worker.
+bool BackgroundSolver::getSolution(const CubeState& state, vector<int>* moves, bool wait, double* milliseconds) {
+    unique_lock<mutex> guard(lock);
+
+    for (;;) {
+        if (!(currentState == state)) {
+            if (!wait)
+                return false;
+            currentState = state;
+            currentSolution.clear();
+            currentValid = false;
+            currentVersion++;
+            changed.notify_one();
+        }
+        if (currentValid || solvedVersion == currentVersion)
+            break;
+        if (!wait)
+            return false;
+        solved.wait(guard);
+    }
+    *moves = currentSolution;
+    if (milliseconds != NULL)
+        *milliseconds = solveMilliseconds;
+    return currentValid;
+}
@@ -0,0 +1,54 @@
+// header file for backgroundsolver.cc
+
+#ifndef BACKGROUNDSOLVER_H
+#define BACKGROUNDSOLVER_H
+
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "cubestate.h"
+
+using namespace std;
+
+class BackgroundSolver {
+private:
+    /***************************************************************
+    ** Keeps a solution for the latest state of a cube that is    **
+    ** turned one move at a time, so the render loop never has to **
+    ** solve. Every move puts its inverse in front of the current **
+    ** solution at once (through optimizeMoves), the worker       **
+    ** thread then replaces it with a TwoPhaseSolver solution     **
+    ** (timeLimitMs) if that one is shorter. A state posted while **
+    ** the worker is busy replaces any state still waiting, only  **
+    ** the newest one is solved.                                  **
+    ***************************************************************/
+    thread worker;
+    mutex lock;
+    condition_variable changed;
+    condition_variable solved;
+
+    CubeState currentState;
+    vector<int> currentSolution;
+    bool currentValid;          // false until a solution for currentState is known
+    uint64_t currentVersion;
+    uint64_t solvedVersion;     // currentVersion the worker last finished
+    double solveMilliseconds;
+    unsigned timeLimitMs;
+    bool stopping;
+
+    BackgroundSolver(const BackgroundSolver&);
+    BackgroundSolver& operator=(const BackgroundSolver&);
+
+    void run();
+
+public:
+    BackgroundSolver(unsigned timeLimitMs=8);
+    ~BackgroundSolver();
+
+    void update(const CubeState& state, int move=-1);
+    bool getSolution(const CubeState& state, vector<int>* moves, bool wait=true, double* milliseconds=NULL);
+};
+
+#endif
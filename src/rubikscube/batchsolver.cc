@@ -0,0 +1,117 @@
+/* standard includes */
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include "batchsolver.h"
+#include "cubecoords.h"
+#include "twophase.h"
+#include "optimal.h"
+#include "threadpool.h"
+#include "moveoptimizer.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+static bool solveLayerByLayer(const CubeState& state, vector<int>* moves) {
+    CubeState normalized = state;
+    vector<int> spins;
+    AlgoCube cube;
+
+    // the layer solver would never finish on a cube that cannot be solved
+    if (!normalizeOrientation(&normalized, &spins) || !isSolvable(normalized))
+        return false;
+    cube.setVerbose(false);
+    cube.setState(state);
+    cube.solveFirstLayer();
+    cube.solveSecondLayer();
+    cube.solveThirdLayer();
+    *moves = cube.getMoves();
+    optimizeMoves(moves);
+    return true;
+}
+
+static void solveOne(const CubeState& state, SolverType solver, Solution* solution) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    solution->moves.clear();
+    switch (solver) {
+        case TWO_PHASE:
+            solution->solved = TwoPhaseSolver::getInstance().solve(state, &solution->moves);
+            break;
+        case OPTIMAL:
+            solution->solved = OptimalSolver::getInstance().solve(state, &solution->moves);
+            break;
+        default:
+            solution->solved = solveLayerByLayer(state, &solution->moves);
+            break;
+    }
+    solution->milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void computeStats(const vector<Solution>& solutions, double seconds, unsigned threads, BatchStats* stats) {
+    vector<double> latencies(solutions.size());
+    double total = 0;
+    size_t i;
+
+    stats->solves = solutions.size();
+    stats->failures = 0;
+    stats->seconds = seconds;
+    stats->threads = threads;
+    for (i = 0; i < solutions.size(); i++) {
+        latencies[i] = solutions[i].milliseconds;
+        total += latencies[i];
+        stats->failures += !solutions[i].solved;
+    }
+    sort(latencies.begin(), latencies.end());
+    stats->averageMilliseconds = latencies.empty() ? 0 : total / latencies.size();
+    stats->medianMilliseconds = latencies.empty() ? 0 : latencies[latencies.size() / 2];
+    stats->p99Milliseconds = latencies.empty() ? 0 : latencies[latencies.size() * 99 / 100];
+    stats->maxMilliseconds = latencies.empty() ? 0 : latencies.back();
+}
+
+
+/**********************************************************************
+**                        FUNCTION DEFINITIONS                       **
+**********************************************************************/
+
+void BatchStats::print() const {
+    printf("%zu solves (%zu failed) on %u threads in %.2f s: %.1f solves/s, latency avg %.2f ms, median %.2f ms, "
+           "p99 %.2f ms, max %.2f ms\n", solves, failures, threads, seconds, getSolvesPerSecond(), averageMilliseconds,
+           medianMilliseconds, p99Milliseconds, maxMilliseconds);
+}
+
+vector<Solution> solveBatch(const CubeState* states, size_t count, SolverType solver, BatchStats* stats, unsigned nrThreads) {
+    vector<Solution> solutions(count);
+    chrono::steady_clock::time_point start;
+    unique_ptr<WorkStealingPool> ownPool;
+    WorkStealingPool* pool = &WorkStealingPool::getInstance();
+
+    if (nrThreads != 0 && nrThreads != pool->getNrThreads()) {
+        ownPool.reset(new WorkStealingPool(nrThreads));
+        pool = ownPool.get();
+    }
+    // table setup is not part of the first solve's latency
+    if (solver == TWO_PHASE)
+        TwoPhaseSolver::getInstance();
+    else if (solver == OPTIMAL)
+        OptimalSolver::getInstance();
+
+    start = chrono::steady_clock::now();
+    pool->parallelFor(count, [states, solver, &solutions](size_t index, unsigned) {
+        solveOne(states[index], solver, &solutions[index]);
+    });
+    if (stats != NULL)
+        computeStats(solutions, chrono::duration<double>(chrono::steady_clock::now() - start).count(), pool->getNrThreads(),
+                     stats);
+    return solutions;
+}
+
+vector<Solution> solveBatch(const vector<CubeState>& states, SolverType solver, BatchStats* stats, unsigned nrThreads) {
+    return solveBatch(states.data(), states.size(), solver, stats, nrThreads);
+}
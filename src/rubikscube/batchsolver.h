@@ -0,0 +1,45 @@
+// header file for batchsolver.cc
+
+#ifndef BATCHSOLVER_H
+#define BATCHSOLVER_H
+
+#include <stddef.h>
+#include <vector>
+#include "cubestate.h"
+#include "rubikscube.h"
+
+using namespace std;
+
+struct Solution {
+    vector<int> moves;          // move codes as in AlgoCube::getMoves, LAYER_BY_LAYER may end with the cube spun
+    bool solved;                // false if the state cannot be solved (or the solver gave up)
+    double milliseconds;        // latency of this solve
+};
+
+struct BatchStats {
+    size_t solves;
+    size_t failures;
+    double seconds;             // wall clock time of the whole batch
+    double averageMilliseconds;
+    double medianMilliseconds;
+    double p99Milliseconds;
+    double maxMilliseconds;
+    unsigned threads;
+
+    double getSolvesPerSecond() const { return seconds > 0 ? solves / seconds : 0; }
+    void print() const;
+};
+
+/***************************************************************
+** Solves independent states on all cores, see                **
+** WorkStealingPool. The solver tables are set up before the  **
+** clock starts. LAYER_BY_LAYER runs a quiet AlgoCube per     **
+** state, TWO_PHASE and OPTIMAL share one solver instance.    **
+** nrThreads 0 uses the shared pool with one thread per cpu.  **
+***************************************************************/
+vector<Solution> solveBatch(const CubeState* states, size_t count, SolverType solver=TWO_PHASE, BatchStats* stats=NULL,
+                            unsigned nrThreads=0);
+vector<Solution> solveBatch(const vector<CubeState>& states, SolverType solver=TWO_PHASE, BatchStats* stats=NULL,
+                            unsigned nrThreads=0);
+
+#endif
@@ -44,6 +44,37 @@ std::array<GLfloat, 6 * 36> Cube::createCubes()
     }
 }
 
+unsigned Cube::getOutwardFaces()
+{
+    unsigned faces = 0;
+
+    if (this->position == this->BOTTOM || this->position == this->BOTTOM_LEFT || this->position == this->BOTTOM_RIGHT)
+    {
+        faces |= 1 << 0;
+    }
+    if (this->position == this->TOP || this->position == this->TOP_LEFT || this->position == this->TOP_RIGHT)
+    {
+        faces |= 1 << 1;
+    }
+    if (this->depth == 0)
+    {
+        faces |= 1 << 2;
+    }
+    if (this->depth == -4.2f)
+    {
+        faces |= 1 << 3;
+    }
+    if (this->position == this->LEFT || this->position == this->TOP_LEFT || this->position == this->BOTTOM_LEFT)
+    {
+        faces |= 1 << 4;
+    }
+    if (this->position == this->RIGHT || this->position == this->TOP_RIGHT || this->position == this->BOTTOM_RIGHT)
+    {
+        faces |= 1 << 5;
+    }
+    return faces;
+}
+
 std::array<GLfloat, 6 * 36> Cube::addCube(std::array<GLfloat, 6 * 36> vtx, int position, GLfloat depth)
 {
     int elementsPerCube = 36 * 6;
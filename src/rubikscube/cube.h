@@ -29,6 +29,9 @@ public:
     };
     array<GLfloat,6*36> createCubes();
 
+    // faces on the outside of the assembled puzzle, bit 0-5 in the face order of initCube
+    unsigned getOutwardFaces();
+
     // array<GLfloat,6*36> getInitCube() {
     //   return initCube;
     // }
@@ -0,0 +1,411 @@
+/* standard includes */
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "cubecoords.h"
+#include "movetable.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+// axis and layer of the faces U R F D L B
+static const unsigned faceAxis[6] = {2, 0, 1, 2, 0, 1};
+static const unsigned faceLayer[6] = {2, 2, 0, 0, 0, 2};
+
+// gathers of the face moves, half turns included
+struct FaceCubeMoves {
+    const CubeMove* moves[NR_FACE_MOVES];
+};
+
+static FaceCubeMoves buildFaceCubeMoves() {
+    FaceCubeMoves table;
+    unsigned face;
+    int quarter;
+
+    for (face = 0; face < 6; face++) {
+        quarter = moveCode(faceAxis[face], faceLayer[face], false);
+        table.moves[3 * face] = &cubeMoveTable.moves[quarter];
+        table.moves[3 * face + 1] = &cubeMoveTable.halfTurns[quarter];
+        table.moves[3 * face + 2] = &cubeMoveTable.moves[inverseMove(quarter)];
+    }
+    return table;
+}
+
+static const FaceCubeMoves& faceCubeMoves() {
+    static const FaceCubeMoves table = buildFaceCubeMoves();
+    return table;
+}
+
+#if defined(CUBESTATE_X86) && !defined(__SSSE3__)
+__attribute__((target("ssse3")))
+static void applyFaceMovesSsse3(CubeState* state, const uint8_t* faceMoves, size_t nrMoves) {
+    const FaceCubeMoves& table = faceCubeMoves();
+    size_t i;
+    for (i = 0; i < nrMoves; i++)
+        applyCubeMoveSsse3(state, *table.moves[faceMoves[i]]);
+}
+#endif
+
+// edge slots of the top and bottom layer, the middle layer slots are 4-7
+static const uint8_t udEdges[8] = {0, 1, 2, 3, 8, 9, 10, 11};
+
+static bool isSliceEdge(unsigned cubie) {
+    return cubie >= 4 && cubie < 8;
+}
+
+static unsigned binomial(unsigned n, unsigned k) {
+    unsigned result = 1, i;
+    if (k > n)
+        return 0;
+    for (i = 1; i <= k; i++)
+        result = result * (n - k + i) / i;
+    return result;
+}
+
+// spins bringing the centers home for the centers of slots 0-2 (bottom, front, left): c0 * 36 + c1 * 6 + c2
+struct OrientationTable {
+    int8_t length[216];         // -1 if no orientation of the cube has these centers
+    int8_t spins[216][3];
+};
+
+// the first spin sequence of every length in the order normalizeOrientation searched them before the table
+static OrientationTable buildOrientationTable() {
+    OrientationTable table;
+    unsigned length, total, sequence, rest, key, i;
+    int spins[3];
+
+    memset(table.length, -1, sizeof(table.length));
+    memset(table.spins, 0, sizeof(table.spins));
+    for (length = 0, total = 1; length <= 3; length++, total *= 6) {
+        for (sequence = 0; sequence < total; sequence++) {
+            CubeState start;
+            for (i = 0, rest = sequence; i < length; i++, rest /= 6)
+                spins[i] = rest % 6;
+            // the centers that these spins bring home
+            for (i = length; i > 0; i--)
+                start.applyMove(inverseMove(spins[i - 1]));
+            key = start.centers[0] * 36 + start.centers[1] * 6 + start.centers[2];
+            if (table.length[key] >= 0)
+                continue;
+            table.length[key] = length;
+            for (i = 0; i < length; i++)
+                table.spins[key][i] = spins[i];
+        }
+    }
+    return table;
+}
+
+static const OrientationTable& orientationTable() {
+    static const OrientationTable table = buildOrientationTable();
+    return table;
+}
+
+static unsigned cubiePermParity(const uint8_t* pieces, unsigned n, unsigned mask) {
+    unsigned parity = 0, i, j;
+    for (i = 0; i < n; i++)
+        for (j = i + 1; j < n; j++)
+            parity ^= (pieces[j] & mask) < (pieces[i] & mask);
+    return parity;
+}
+
+
+
+/**********************************************************************
+**                       COORDINATE FUNCTIONS                        **
+**********************************************************************/
+
+// lexicographic rank of the permutation p of 0..n-1
+unsigned permutationRank(const uint8_t* p, unsigned n) {
+    unsigned rank = 0, smaller, i, j;
+    for (i = 0; i < n; i++) {
+        smaller = 0;
+        for (j = i + 1; j < n; j++) {
+            if (p[j] < p[i])
+                smaller++;
+        }
+        rank = rank * (n - i) + smaller;
+    }
+    return rank;
+}
+
+void permutationUnrank(unsigned rank, uint8_t* p, unsigned n) {
+    uint8_t digits[8], available[8];
+    unsigned i;
+    for (i = n; i-- > 0;) {
+        digits[i] = rank % (n - i);
+        rank /= n - i;
+    }
+    for (i = 0; i < n; i++)
+        available[i] = i;
+    for (i = 0; i < n; i++) {
+        p[i] = available[digits[i]];
+        memmove(available + digits[i], available + digits[i] + 1, n - i - digits[i] - 1);
+    }
+}
+
+unsigned getTwist(const CubeState& state) {
+    unsigned twist = 0, i;
+    for (i = 0; i < 7; i++)
+        twist = 3*twist + state.cornerTwist(i);
+    return twist;
+}
+
+void setTwist(CubeState* state, unsigned twist) {
+    unsigned sum = 0, i;
+    for (i = 7; i-- > 0;) {
+        state->corners[i] = state->cornerPerm(i) | (twist % 3) << 3;
+        sum += twist % 3;
+        twist /= 3;
+    }
+    state->corners[7] = state->cornerPerm(7) | ((3 - sum % 3) % 3) << 3;
+}
+
+unsigned getFlip(const CubeState& state) {
+    unsigned flip = 0, i;
+    for (i = 0; i < 11; i++)
+        flip = 2*flip + state.edgeFlip(i);
+    return flip;
+}
+
+void setFlip(CubeState* state, unsigned flip) {
+    unsigned sum = 0, i;
+    for (i = 11; i-- > 0;) {
+        state->edges[i] = state->edgePerm(i) | (flip & 1) << 4;
+        sum += flip & 1;
+        flip >>= 1;
+    }
+    state->edges[11] = state->edgePerm(11) | (sum & 1) << 4;
+}
+
+// slots of the middle layer edges, whichever they are
+unsigned getSlice(const CubeState& state) {
+    unsigned slice = 0, found = 0;
+    int j;
+    for (j = 11; j >= 0; j--) {
+        if (isSliceEdge(state.edgePerm(j))) {
+            slice += binomial(11 - j, found + 1);
+            found++;
+        }
+    }
+    return slice;
+}
+
+void setSlice(CubeState* state, unsigned slice) {
+    unsigned left = 4, other = 0, j;
+    for (j = 0; j < 12; j++) {
+        if (left > 0 && slice >= binomial(11 - j, left)) {
+            slice -= binomial(11 - j, left);
+            state->edges[j] = 8 - left--;
+        }
+        else {
+            state->edges[j] = udEdges[other++];
+        }
+    }
+}
+
+unsigned getCornerPerm(const CubeState& state) {
+    uint8_t p[8];
+    unsigned i;
+    for (i = 0; i < 8; i++)
+        p[i] = state.cornerPerm(i);
+    return permutationRank(p, 8);
+}
+
+void setCornerPerm(CubeState* state, unsigned perm) {
+    permutationUnrank(perm, state->corners, 8);
+}
+
+// permutation of the top and bottom layer edges, only defined inside the subgroup
+unsigned getEdgePerm(const CubeState& state) {
+    uint8_t p[8];
+    unsigned cubie, i;
+    for (i = 0; i < 8; i++) {
+        cubie = state.edgePerm(udEdges[i]);
+        p[i] = cubie < 4 ? cubie : cubie - 4;
+    }
+    return permutationRank(p, 8);
+}
+
+void setEdgePerm(CubeState* state, unsigned perm) {
+    uint8_t p[8];
+    unsigned i;
+    permutationUnrank(perm, p, 8);
+    for (i = 0; i < 8; i++)
+        state->edges[udEdges[i]] = udEdges[p[i]];
+}
+
+unsigned getSlicePerm(const CubeState& state) {
+    uint8_t p[4];
+    unsigned i;
+    for (i = 0; i < 4; i++)
+        p[i] = state.edgePerm(4 + i) - 4;
+    return permutationRank(p, 4);
+}
+
+void setSlicePerm(CubeState* state, unsigned perm) {
+    uint8_t p[4];
+    unsigned i;
+    permutationUnrank(perm, p, 4);
+    for (i = 0; i < 4; i++)
+        state->edges[4 + i] = 4 + p[i];
+}
+
+// one gather for every face move, half turns included
+void applyFaceMove(CubeState* state, unsigned faceMove) {
+    applyCubeMove(state, *faceCubeMoves().moves[faceMove]);
+}
+
+// the kernel is chosen once for all moves, see CubeState::applyMoves
+void applyFaceMoves(CubeState* state, const uint8_t* faceMoves, size_t nrMoves) {
+    const FaceCubeMoves& table = faceCubeMoves();
+    size_t i;
+
+#if defined(CUBESTATE_X86) && !defined(__SSSE3__)
+    if (cubeMovesSsse3) {
+        applyFaceMovesSsse3(state, faceMoves, nrMoves);
+        return;
+    }
+#endif
+    for (i = 0; i < nrMoves; i++)
+        applyCubeMove(state, *table.moves[faceMoves[i]]);
+}
+
+void getEdgeSlots(const CubeState& state, uint8_t* slots) {
+    unsigned slot;
+    for (slot = 0; slot < 12; slot++)
+        slots[state.edgePerm(slot)] = slot | state.edgeFlip(slot) << 4;
+}
+
+// slots of the first six entries of slots as a partial permutation of the 12 slots, flips in the low bits
+unsigned edgeSubsetRank(const uint8_t* slots) {
+    unsigned rank = 0, flips = 0, used = 0, slot, i;
+    for (i = 0; i < 6; i++) {
+        slot = slots[i] & 15;
+        rank = rank * (12 - i) + slot - __builtin_popcount(used & ((1u << slot) - 1));
+        used |= 1u << slot;
+        flips = 2*flips + (slots[i] >> 4);
+    }
+    return rank * 64 + flips;
+}
+
+void edgeSubsetUnrank(unsigned rank, uint8_t* slots) {
+    unsigned digits[6], flips = rank % 64, used = 0, slot, i;
+    rank /= 64;
+    for (i = 6; i-- > 0;) {
+        digits[i] = rank % (12 - i);
+        rank /= 12 - i;
+    }
+    for (i = 0; i < 6; i++) {
+        // digits[i]-th slot not used yet
+        for (slot = 0; ; slot++) {
+            if (used & (1u << slot))
+                continue;
+            if (digits[i] == 0)
+                break;
+            digits[i]--;
+        }
+        used |= 1u << slot;
+        slots[i] = slot | (flips >> (5 - i) & 1) << 4;
+    }
+}
+
+
+/**********************************************************************
+**                         FACE MOVE FUNCTIONS                       **
+**********************************************************************/
+
+// quarter turns as one move code, half turns as two
+void appendFaceMove(unsigned faceMove, vector<int>* moves) {
+    int quarter = moveCode(faceAxis[faceMove / 3], faceLayer[faceMove / 3], false);
+    switch (faceMove % 3) {
+        case 0:
+            moves->push_back(quarter);
+            break;
+        case 1:
+            moves->push_back(quarter);
+            moves->push_back(quarter);
+            break;
+        case 2:
+            moves->push_back(inverseMove(quarter));
+            break;
+    }
+}
+
+// the same face twice in a row and both orders of opposite faces are redundant
+bool isRedundantFace(unsigned face, unsigned lastFace) {
+    return lastFace != NO_FACE && (face == lastFace || face + 3 == lastFace);
+}
+
+// spins the whole cube until the centers are home (at most three spins, looked up from the centers of the bottom, front
+// and left slot), returns false if the centers are scrambled. moves may be NULL.
+bool normalizeOrientation(CubeState* state, vector<int>* moves) {
+    const OrientationTable& table = orientationTable();
+    unsigned key = state->centers[0] * 36 + state->centers[1] * 6 + state->centers[2];
+    CubeState spun = *state;
+    int i;
+
+    if (state->centers[0] >= 6 || state->centers[1] >= 6 || state->centers[2] >= 6 || table.length[key] < 0)
+        return false;
+    for (i = 0; i < table.length[key]; i++)
+        spun.applyMove(table.spins[key][i]);
+    for (i = 0; i < 6 && spun.centers[i] == i; i++);
+    if (i < 6)
+        return false;
+    *state = spun;
+    if (moves != NULL)
+        moves->insert(moves->end(), table.spins[key], table.spins[key] + table.length[key]);
+    return true;
+}
+
+// why state cannot be reached by turning a solved cube, in constant time. Twist, flip and parity are checked in the
+// home orientation as the slice turns hidden in the spins change them.
+StateCheck checkState(const CubeState& state) {
+    CubeState oriented = state;
+    unsigned corners = 0, edges = 0, centers = 0, twist = 0, flip = 0, i;
+
+    for (i = 0; i < 8; i++)
+        corners |= 1 << state.cornerPerm(i);
+    for (i = 0; i < 12; i++)
+        edges |= 1 << state.edgePerm(i);
+    for (i = 0; i < 6; i++)
+        centers |= 1 << state.centers[i];
+    if (corners != 0xff || edges != 0xfff || centers != 0x3f)
+        return STATE_MISSING_PIECE;
+    if (!normalizeOrientation(&oriented, NULL))
+        return STATE_BAD_CENTERS;
+
+    for (i = 0; i < 8; i++)
+        twist += oriented.cornerTwist(i);
+    for (i = 0; i < 12; i++)
+        flip += oriented.edgeFlip(i);
+    if (twist % 3 != 0)
+        return STATE_TWISTED_CORNER;
+    if (flip % 2 != 0)
+        return STATE_FLIPPED_EDGE;
+    if (cubiePermParity(oriented.corners, 8, 7) != cubiePermParity(oriented.edges, 12, 15))
+        return STATE_SWAPPED_PIECES;
+    return STATE_SOLVABLE;
+}
+
+const char* getStateCheckText(StateCheck check) {
+    switch (check) {
+        case STATE_SOLVABLE: return "solvable";
+        case STATE_BAD_FACELETS: return "facelets do not describe a cube";
+        case STATE_MISSING_PIECE: return "a piece is missing or occurs twice";
+        case STATE_BAD_CENTERS: return "the centers are not in the order of a real cube";
+        case STATE_TWISTED_CORNER: return "a corner is twisted";
+        case STATE_FLIPPED_EDGE: return "an edge is flipped";
+        case STATE_SWAPPED_PIECES: return "two pieces are swapped";
+    }
+    return "unknown";
+}
+
+// every cubie once, centers of a real cube, twists summing to 0 mod 3, flips to 0 mod 2 and equal corner and edge
+// permutation parity
+bool isSolvable(const CubeState& state) {
+    return checkState(state) == STATE_SOLVABLE;
+}
@@ -0,0 +1,73 @@
+// header file for cubecoords.cc
+
+#ifndef CUBECOORDS_H
+#define CUBECOORDS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "cubestate.h"
+
+using namespace std;
+
+/***************************************************************
+** Coordinates of CubeState shared by the table based solvers **
+** Face moves are 3*face + power-1 with the faces U R F D L B **
+** (z top, x right, y front, z bottom, x left, y back), the   **
+** opposite face of face is face+3 (mod 6). Coordinates count **
+** from 0 for the solved cube.                                **
+***************************************************************/
+
+const int NR_FACE_MOVES = 18;
+const unsigned NO_FACE = 6;
+
+const unsigned NR_TWISTS = 2187;        // 3^7, the twist of the last corner follows
+const unsigned NR_FLIPS = 2048;         // 2^11
+const unsigned NR_SLICES = 495;         // 12 choose 4 slots of the middle layer edges
+const unsigned NR_PERMS = 40320;        // 8!
+const unsigned NR_SLICE_PERMS = 24;     // 4!
+const unsigned NR_EDGE_SUBSETS = 42577920;  // 12!/6! slots of six edges times 2^6 flips
+
+unsigned permutationRank(const uint8_t* p, unsigned n);
+void permutationUnrank(unsigned rank, uint8_t* p, unsigned n);
+
+unsigned getTwist(const CubeState& state);
+void setTwist(CubeState* state, unsigned twist);
+unsigned getFlip(const CubeState& state);
+void setFlip(CubeState* state, unsigned flip);
+unsigned getSlice(const CubeState& state);
+void setSlice(CubeState* state, unsigned slice);
+unsigned getCornerPerm(const CubeState& state);
+void setCornerPerm(CubeState* state, unsigned perm);
+unsigned getEdgePerm(const CubeState& state);
+void setEdgePerm(CubeState* state, unsigned perm);
+unsigned getSlicePerm(const CubeState& state);
+void setSlicePerm(CubeState* state, unsigned perm);
+
+// slots of edges: slot | flip << 4 for each edge cubie
+void getEdgeSlots(const CubeState& state, uint8_t* slots);
+unsigned edgeSubsetRank(const uint8_t* slots);
+void edgeSubsetUnrank(unsigned rank, uint8_t* slots);
+
+void applyFaceMove(CubeState* state, unsigned faceMove);
+void applyFaceMoves(CubeState* state, const uint8_t* faceMoves, size_t nrMoves);
+void appendFaceMove(unsigned faceMove, vector<int>* moves);
+bool isRedundantFace(unsigned face, unsigned lastFace);
+
+// result of checkState, STATE_BAD_FACELETS is left to the parsers of facelet strings
+enum StateCheck {
+    STATE_SOLVABLE,
+    STATE_BAD_FACELETS,
+    STATE_MISSING_PIECE,
+    STATE_BAD_CENTERS,
+    STATE_TWISTED_CORNER,
+    STATE_FLIPPED_EDGE,
+    STATE_SWAPPED_PIECES
+};
+
+bool normalizeOrientation(CubeState* state, vector<int>* moves);
+StateCheck checkState(const CubeState& state);
+const char* getStateCheckText(StateCheck check);
+bool isSolvable(const CubeState& state);
+
+#endif
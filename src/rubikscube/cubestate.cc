@@ -0,0 +1,311 @@
+/* standard includes */
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "cubestate.h"
+#include "movetable.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                            SLOT TABLES                            **
+**********************************************************************/
+
+// [x: left->right] [y: front->back] [z: bottom->top] of every slot, this is also the home position of the cubie with the same index
+static constexpr uint8_t cornerCoords[8][3] = {
+    {0, 0, 0}, {2, 0, 0}, {0, 2, 0}, {2, 2, 0},
+    {0, 0, 2}, {2, 0, 2}, {0, 2, 2}, {2, 2, 2}
+};
+
+static constexpr uint8_t edgeCoords[12][3] = {
+    {1, 0, 0}, {0, 1, 0}, {2, 1, 0}, {1, 2, 0},
+    {0, 0, 1}, {2, 0, 1}, {0, 2, 1}, {2, 2, 1},
+    {1, 0, 2}, {0, 1, 2}, {2, 1, 2}, {1, 2, 2}
+};
+
+static constexpr uint8_t centerCoords[6][3] = {
+    {1, 1, 0}, {1, 0, 1}, {0, 1, 1}, {2, 1, 1}, {1, 2, 1}, {1, 1, 2}
+};
+
+// slot index of every position (x + 3*y + 9*z), the kind of piece follows from the number of middle (1) coordinates
+static constexpr uint8_t positionSlot[27] = {
+    0, 0, 1,   1, 0, 2,   2, 3, 3,
+    4, 1, 5,   2, 0, 3,   6, 4, 7,
+    4, 8, 5,   9, 5, 10,  6, 11, 7
+};
+
+static unsigned nrMiddleCoords(unsigned x, unsigned y, unsigned z) {
+    return (x == 1) + (y == 1) + (z == 1);
+}
+
+// color of the surface facing along axis (0: left-right, 1: front-back, 2: top-bottom) at coordinate 0 or 2
+static char surfaceColor(unsigned axis, unsigned coord) {
+    static const char colors[3][2] = {{'b', 'g'}, {'r', 'o'}, {'w', 'y'}};
+    return colors[axis][coord / 2];
+}
+
+// fills colors with the solved colors of the piece at the passed position (CubePiece notation order), returns their number
+static unsigned homeColors(unsigned x, unsigned y, unsigned z, char* colors) {
+    unsigned n = 0;
+    if (y != 1)
+        colors[n++] = surfaceColor(1, y);
+    if (z != 1)
+        colors[n++] = surfaceColor(2, z);
+    if (x != 1)
+        colors[n++] = surfaceColor(0, x);
+    return n;
+}
+
+// corner slots alternate in handedness with every coordinate that is mirrored
+static constexpr unsigned cornerChirality(const uint8_t* c) {
+    return ((c[0] + c[1] + c[2]) / 2) & 1;
+}
+
+// index of the reference color (top/bottom, middle layer: front/back) within the edge notation order
+static unsigned edgeReferenceIndex(const uint8_t* c) {
+    return c[0] == 1 ? 1 : 0;
+}
+
+// returns false if the passed char is no cube color
+static bool colorPosition(char color, unsigned* axis, unsigned* coord) {
+    switch (color) {
+        case 'b': *axis = 0; *coord = 0; return true;
+        case 'g': *axis = 0; *coord = 2; return true;
+        case 'r': *axis = 1; *coord = 0; return true;
+        case 'o': *axis = 1; *coord = 2; return true;
+        case 'w': *axis = 2; *coord = 0; return true;
+        case 'y': *axis = 2; *coord = 2; return true;
+    }
+    return false;
+}
+
+
+/**********************************************************************
+**                         CUBIE MOVE TABLES                         **
+**********************************************************************/
+
+static constexpr unsigned slotPosition(const uint8_t* c) {
+    return c[0] + 3*c[1] + 9*c[2];
+}
+
+// a then b in one gather
+static constexpr CubeMove composeMoves(const CubeMove& a, const CubeMove& b) {
+    CubeMove m = {};
+    for (unsigned i = 0; i < 16; i++) {
+        m.cornerFrom[i] = a.cornerFrom[b.cornerFrom[i]];
+        m.cornerTwist[i] = (((a.cornerTwist[b.cornerFrom[i]] >> 3) + (b.cornerTwist[i] >> 3)) % 3) << 3;
+        m.edgeFrom[i] = a.edgeFrom[b.edgeFrom[i]];
+        m.edgeFlip[i] = a.edgeFlip[b.edgeFrom[i]] ^ b.edgeFlip[i];
+    }
+    return m;
+}
+
+// derives the cubie tables from the position table, a turn swaps two color axes of every turned piece
+static constexpr CubeMoveTable buildCubeMoveTable() {
+    CubeMoveTable table = {};
+    for (int move = 0; move < NR_MOVES; move++) {
+        CubeMove& m = table.moves[move];
+        unsigned axis = moveAxis(move);
+        unsigned i = 0;
+        unsigned from = 0;
+
+        // padding bytes gather themselves
+        for (i = 0; i < 16; i++) {
+            m.cornerFrom[i] = i;
+            m.edgeFrom[i] = i;
+        }
+
+        for (i = 0; i < 8; i++) {
+            from = positionMoveTable.from[move][slotPosition(cornerCoords[i])];
+            m.cornerFrom[i] = positionSlot[from];
+            // corners twist unless the top/bottom axis stays where it is
+            if (isPositionInMove(from, move) && axis != 2)
+                m.cornerTwist[i] = (((axis == 0) == (cornerChirality(cornerCoords[positionSlot[from]]) == 0)) ? 1 : 2) << 3;
+        }
+        for (i = 0; i < 12; i++) {
+            from = positionMoveTable.from[move][slotPosition(edgeCoords[i])];
+            m.edgeFrom[i] = positionSlot[from];
+            // front/back layers and the middle slices move the reference color onto another axis
+            if (isPositionInMove(from, move) && (axis == 1 || edgeCoords[positionSlot[from]][axis] == 1))
+                m.edgeFlip[i] = 1 << 4;
+        }
+        for (i = 0; i < 6; i++)
+            m.cornerFrom[8 + i] = 8 + positionSlot[positionMoveTable.from[move][slotPosition(centerCoords[i])]];
+        table.halfTurns[move] = composeMoves(m, m);
+    }
+    return table;
+}
+
+extern constexpr CubeMoveTable cubeMoveTable = buildCubeMoveTable();
+
+#ifdef CUBESTATE_X86
+// static constructors of other files may turn the cube before this one runs, they get the scalar gather until then
+extern const bool cubeMovesSsse3 = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3") != 0;
+}();
+
+#ifndef __SSSE3__
+__attribute__((target("ssse3")))
+static void applyMovesSsse3(CubeState* state, const int* moves, size_t nrMoves) {
+    for (size_t i = 0; i < nrMoves; i++)
+        applyCubeMoveSsse3(state, cubeMoveTable.moves[moves[i]]);
+}
+#endif
+#endif
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+CubeState::CubeState() {
+    reset();
+}
+
+// every cubie in its home slot, cube in its initial orientation
+void CubeState::reset() {
+    unsigned i;
+    for (i = 0; i < 8; i++)
+        corners[i] = i;
+    for (i = 0; i < 12; i++)
+        edges[i] = i;
+    for (i = 0; i < 6; i++)
+        centers[i] = i;
+    memset(cornerPadding, 0, sizeof(cornerPadding));
+    memset(edgePadding, 0, sizeof(edgePadding));
+}
+
+// true for the solved cube in its initial orientation (white bottom, red front)
+bool CubeState::isSolved() const {
+    return *this == CubeState();
+}
+
+bool CubeState::operator==(const CubeState& other) const {
+    return memcmp(corners, other.corners, sizeof(corners)) == 0 && memcmp(edges, other.edges, sizeof(edges)) == 0
+        && memcmp(centers, other.centers, sizeof(centers)) == 0;
+}
+
+bool CubeState::operator!=(const CubeState& other) const {
+    return !(*this == other);
+}
+
+// writes the colors of the piece at the passed position into colors, returns the number of colors (core: "-")
+unsigned CubeState::getColors(unsigned x, unsigned y, unsigned z, char* colors) const {
+    unsigned slot = positionSlot[x + 3*y + 9*z];
+    unsigned cubie, orientation, k;
+    char home[3];
+
+    switch (nrMiddleCoords(x, y, z)) {
+        case 0: {
+            const uint8_t* slotCoords = cornerCoords[slot];
+            cubie = cornerPerm(slot);
+            homeColors(cornerCoords[cubie][0], cornerCoords[cubie][1], cornerCoords[cubie][2], home);
+
+            // position of the top/bottom color, the other two follow from the handedness of slot and cubie
+            if (cornerChirality(slotCoords) == 0)
+                orientation = (cornerTwist(slot) + 1) % 3;
+            else
+                orientation = (4 - cornerTwist(slot)) % 3;
+
+            for (k = 0; k < 3; k++) {
+                if (cornerChirality(slotCoords) == cornerChirality(cornerCoords[cubie]))
+                    colors[(k + orientation + 2) % 3] = home[k];
+                else
+                    colors[(orientation + 4 - k) % 3] = home[k];
+            }
+            return 3;
+        }
+        case 1: {
+            unsigned slotRef = edgeReferenceIndex(edgeCoords[slot]);
+            cubie = edgePerm(slot);
+            homeColors(edgeCoords[cubie][0], edgeCoords[cubie][1], edgeCoords[cubie][2], home);
+            unsigned cubieRef = edgeReferenceIndex(edgeCoords[cubie]);
+
+            if (edgeFlip(slot) == 0) {
+                colors[slotRef] = home[cubieRef];
+                colors[1 - slotRef] = home[1 - cubieRef];
+            }
+            else {
+                colors[slotRef] = home[1 - cubieRef];
+                colors[1 - slotRef] = home[cubieRef];
+            }
+            return 2;
+        }
+        case 2:
+            cubie = centers[slot];
+            return homeColors(centerCoords[cubie][0], centerCoords[cubie][1], centerCoords[cubie][2], colors);
+    }
+
+    colors[0] = '-';
+    return 1;
+}
+
+char CubeState::getColor(unsigned x, unsigned y, unsigned z, unsigned index) const {
+    char colors[3];
+    getColors(x, y, z, colors);
+    return colors[index];
+}
+
+// puts the piece with the passed colors (CubePiece notation order) at the position, returns false if no such piece fits there
+bool CubeState::setColors(unsigned x, unsigned y, unsigned z, const char* colors, unsigned nrColors) {
+    unsigned home[3] = {1, 1, 1};
+    unsigned axis, coord, i, slot, cubie;
+    char check[3];
+
+    if (nrMiddleCoords(x, y, z) == 3)
+        return nrColors == 1;
+    if (nrColors != 3 - nrMiddleCoords(x, y, z))
+        return false;
+
+    // every color pins one coordinate of the home position of the cubie
+    for (i = 0; i < nrColors; i++) {
+        if (!colorPosition(colors[i], &axis, &coord) || home[axis] != 1)
+            return false;
+        home[axis] = coord;
+    }
+    cubie = positionSlot[home[0] + 3*home[1] + 9*home[2]];
+    slot = positionSlot[x + 3*y + 9*z];
+
+    if (nrColors == 3) {
+        for (i = 0; i < 3; i++) {
+            colorPosition(colors[i], &axis, &coord);
+            if (axis == 2)
+                break;
+        }
+        if (cornerChirality(cornerCoords[slot]) == 0)
+            corners[slot] = cubie | ((i + 2) % 3) << 3;
+        else
+            corners[slot] = cubie | ((4 - i) % 3) << 3;
+    }
+    else if (nrColors == 2) {
+        char cubieColors[2];
+        homeColors(home[0], home[1], home[2], cubieColors);
+        char reference = cubieColors[edgeReferenceIndex(edgeCoords[cubie])];
+        edges[slot] = cubie | (colors[edgeReferenceIndex(edgeCoords[slot])] == reference ? 0 : 1) << 4;
+    }
+    else {
+        centers[slot] = cubie;
+    }
+
+    // mirrored corners cannot be represented
+    getColors(x, y, z, check);
+    return memcmp(check, colors, nrColors) == 0;
+}
+
+void CubeState::applyMoves(const vector<int>& moves) {
+    applyMoves(moves.data(), moves.size());
+}
+
+// the kernel is chosen once for all moves, the shuffle stays inlined in the loop
+void CubeState::applyMoves(const int* moves, size_t nrMoves) {
+#if defined(CUBESTATE_X86) && !defined(__SSSE3__)
+    if (cubeMovesSsse3) {
+        applyMovesSsse3(this, moves, nrMoves);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < nrMoves; i++)
+        applyMove(moves[i]);
+}
@@ -0,0 +1,138 @@
+// header file for cubestate.cc
+
+#ifndef CUBESTATE_H
+#define CUBESTATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#define CUBESTATE_X86
+#endif
+#include "movetable.h"
+
+using namespace std;
+
+// gather tables of one move code over the two 16 byte lanes of CubeState
+struct alignas(64) CubeMove {
+    uint8_t cornerFrom[16];     // corners and centers: byte the piece now in the slot came from
+    uint8_t cornerTwist[16];    // twist added to it, already shifted into bits 3-4
+    uint8_t edgeFrom[16];
+    uint8_t edgeFlip[16];       // flip toggled, already shifted into bit 4
+};
+
+struct CubeMoveTable {
+    CubeMove moves[NR_MOVES];
+    CubeMove halfTurns[NR_MOVES];   // the move code twice in one gather
+};
+
+extern const CubeMoveTable cubeMoveTable;
+#ifdef CUBESTATE_X86
+extern const bool cubeMovesSsse3;   // the cpu has pshufb, looked up once at startup
+#endif
+
+class alignas(16) CubeState {
+public:
+    /***************************************************************
+    ** Compact cubie level state of the cube (32 bytes, no heap). **
+    ** Slots are numbered in the order AlgoCube scans its pieces  **
+    ** ([z][y][x] ascending), see the tables in cubestate.cc.     **
+    ** Corners + centers and edges each fill one 16 byte lane, a  **
+    ** move is one byte shuffle per lane (padding stays zero).    **
+    ** CORNERS -- bits 0-2: cubie, bits 3-4: twist (0..2)         **
+    **         -- twist counts from the top/bottom color          **
+    ** EDGES   -- bits 0-3: cubie, bit 4: flip (0..1)             **
+    **         -- flip counts from the top/bottom color, middle   **
+    **            layer edges from the front/back color           **
+    ** CENTERS -- cubie (0..5), centers move with the slice and   **
+    **            whole cube spins                                **
+    ***************************************************************/
+    uint8_t corners[8];
+    uint8_t centers[6];
+    uint8_t cornerPadding[2];
+    uint8_t edges[12];
+    uint8_t edgePadding[4];
+
+    CubeState();
+    void reset();
+    bool isSolved() const;
+    bool operator==(const CubeState& other) const;
+    bool operator!=(const CubeState& other) const;
+
+    unsigned cornerPerm(unsigned slot) const { return corners[slot] & 7; }
+    unsigned cornerTwist(unsigned slot) const { return corners[slot] >> 3; }
+    unsigned edgePerm(unsigned slot) const { return edges[slot] & 15; }
+    unsigned edgeFlip(unsigned slot) const { return edges[slot] >> 4; }
+
+    // colors in the notation order of CubePiece (front-back, top-bottom, left-right)
+    unsigned getColors(unsigned x, unsigned y, unsigned z, char* colors) const;
+    char getColor(unsigned x, unsigned y, unsigned z, unsigned index) const;
+    bool setColors(unsigned x, unsigned y, unsigned z, const char* colors, unsigned nrColors);
+
+    void applyMove(int move);
+    void applyHalfTurn(int move);
+    void applyMoves(const vector<int>& moves);
+    void applyMoves(const int* moves, size_t nrMoves);
+};
+
+// portable gather, used where the cpu has no pshufb
+inline void applyCubeMoveScalar(CubeState* state, const CubeMove& m) {
+    uint8_t c[16], e[16], lane[16];
+    unsigned i, corner;
+
+    memcpy(c, state->corners, 16);
+    memcpy(e, state->edges, 16);
+    for (i = 0; i < 16; i++) {
+        corner = c[m.cornerFrom[i]] + m.cornerTwist[i];
+        lane[i] = corner >= 24 ? corner - 24 : corner;
+    }
+    memcpy(state->corners, lane, 16);
+    for (i = 0; i < 16; i++)
+        lane[i] = e[m.edgeFrom[i]] ^ m.edgeFlip[i];
+    memcpy(state->edges, lane, 16);
+}
+
+#ifdef CUBESTATE_X86
+// one byte shuffle per lane. Built for ssse3 whatever the flags of the build, callers check cubeMovesSsse3 first.
+__attribute__((target("ssse3")))
+inline void applyCubeMoveSsse3(CubeState* state, const CubeMove& m) {
+    __m128i c = _mm_load_si128((const __m128i*) state->corners);
+    __m128i e = _mm_load_si128((const __m128i*) state->edges);
+
+    c = _mm_add_epi8(_mm_shuffle_epi8(c, _mm_load_si128((const __m128i*) m.cornerFrom)), _mm_load_si128((const __m128i*) m.cornerTwist));
+    // twist modulo 3: subtracting 24 wraps every byte below 24 to a larger value
+    c = _mm_min_epu8(c, _mm_sub_epi8(c, _mm_set1_epi8(24)));
+    e = _mm_xor_si128(_mm_shuffle_epi8(e, _mm_load_si128((const __m128i*) m.edgeFrom)), _mm_load_si128((const __m128i*) m.edgeFlip));
+
+    _mm_store_si128((__m128i*) state->corners, c);
+    _mm_store_si128((__m128i*) state->edges, e);
+}
+#endif
+
+// builds with -mssse3 inline the shuffle, the others ask the cpu. Loops over many moves should go through
+// CubeState::applyMoves, which asks once per call instead of once per move.
+inline void applyCubeMove(CubeState* state, const CubeMove& m) {
+#if defined(__SSSE3__)
+    applyCubeMoveSsse3(state, m);
+#elif defined(CUBESTATE_X86)
+    if (cubeMovesSsse3)
+        applyCubeMoveSsse3(state, m);
+    else
+        applyCubeMoveScalar(state, m);
+#else
+    applyCubeMoveScalar(state, m);
+#endif
+}
+
+// applies one of the 24 move codes (see movetable.h), inline since the search loops of the solvers live on it
+inline void CubeState::applyMove(int move) {
+    applyCubeMove(this, cubeMoveTable.moves[move]);
+}
+
+inline void CubeState::applyHalfTurn(int move) {
+    applyCubeMove(this, cubeMoveTable.halfTurns[move]);
+}
+
+#endif
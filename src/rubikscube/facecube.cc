@@ -0,0 +1,367 @@
+/* standard includes */
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include "facecube.h"
+#include "movetable.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FACECUBE_X86
+#endif
+
+using namespace std;
+
+
+/**********************************************************************
+**                         FACELET GEOMETRY                          **
+**********************************************************************/
+
+// solved color of the faces in U R F D L B order
+static const char faceColors[] = "ygrwbo";
+
+struct FaceletPoint {
+    unsigned position;  // x + 3*y + 9*z of the piece carrying the facelet
+    unsigned normal;    // position of the center the facelet faces away from, same encoding
+};
+
+// see the facelet layout in facecube.h
+static constexpr FaceletPoint faceletPoint(unsigned facelet) {
+    unsigned r = facelet % 9 / 3;
+    unsigned c = facelet % 3;
+    switch (facelet / 9) {
+        case 0: return {c + 3*(2 - r) + 9*2, 1 + 3*1 + 9*2};
+        case 1: return {2 + 3*c + 9*(2 - r), 2 + 3*1 + 9*1};
+        case 2: return {c + 3*0 + 9*(2 - r), 1 + 3*0 + 9*1};
+        case 3: return {c + 3*r + 9*0,       1 + 3*1 + 9*0};
+        case 4: return {0 + 3*(2 - c) + 9*(2 - r), 0 + 3*1 + 9*1};
+        default: return {(2 - c) + 3*2 + 9*(2 - r), 1 + 3*2 + 9*1};
+    }
+}
+
+// 0: x, 1: y, 2: z
+static constexpr unsigned faceletAxis(unsigned facelet) {
+    return facelet / 9 % 3 == 0 ? 2 : facelet / 9 % 3 == 1 ? 0 : 1;
+}
+
+static constexpr unsigned findFacelet(unsigned position, unsigned normal) {
+    for (unsigned f = 0; f < NR_FACELETS; f++) {
+        if (faceletPoint(f).position == position && faceletPoint(f).normal == normal)
+            return f;
+    }
+    return NR_FACELETS;
+}
+
+struct PositionFacelets {
+    // facelet of [position] facing along [axis], NR_FACELETS if there is none
+    uint8_t facelet[27][3];
+};
+
+static constexpr PositionFacelets buildPositionFacelets() {
+    PositionFacelets table = {};
+    unsigned position = 0, axis = 0, f = 0;
+    for (position = 0; position < 27; position++)
+        for (axis = 0; axis < 3; axis++)
+            table.facelet[position][axis] = NR_FACELETS;
+    for (f = 0; f < NR_FACELETS; f++)
+        table.facelet[faceletPoint(f).position][faceletAxis(f)] = f;
+    return table;
+}
+
+static constexpr PositionFacelets positionFacelets = buildPositionFacelets();
+
+// index of the color facing along axis within the notation order of CubePiece (front-back, top-bottom, left-right)
+static unsigned colorIndex(unsigned position, unsigned axis) {
+    unsigned y = position / 3 % 3, z = position / 9;
+    switch (axis) {
+        case 1: return 0;
+        case 2: return y != 1;
+        default: return (y != 1) + (z != 1);
+    }
+}
+
+
+/**********************************************************************
+**                         FACELET MOVE TABLES                       **
+**********************************************************************/
+
+struct alignas(32) FaceMove {
+    uint8_t from[64];               // facelet the sticker now on the facelet came from
+    uint8_t laneMask[4][4][16];     // pshufb masks [destination lane][source lane], 0x80 clears
+    uint8_t ymmMask[2][4][32];      // [destination register][low, swapped low, high, swapped high register]
+};
+
+struct FaceMoveTable {
+    FaceMove moves[NR_MOVES];
+};
+
+// source lane of the half of an AVX2 register, see FaceMove::ymmMask
+static constexpr unsigned ymmSourceLane(unsigned variant, unsigned half) {
+    return variant == 0 ? half : variant == 1 ? 1 - half : variant == 2 ? 2 + half : 3 - half;
+}
+
+static constexpr FaceMoveTable buildFaceMoveTable() {
+    FaceMoveTable table = {};
+    for (int move = 0; move < NR_MOVES; move++) {
+        FaceMove& m = table.moves[move];
+        unsigned i = 0, lane = 0, source = 0, reg = 0, variant = 0, half = 0;
+        bool reverse = !isReverseMove(move);
+
+        for (i = 0; i < 64; i++)
+            m.from[i] = i;
+        for (i = 0; i < NR_FACELETS; i++) {
+            FaceletPoint p = faceletPoint(i);
+            if (isPositionInMove(p.position, move))
+                m.from[i] = findFacelet(turnPosition(p.position, moveAxis(move), reverse), turnPosition(p.normal, moveAxis(move), reverse));
+        }
+
+        for (lane = 0; lane < 4; lane++)
+            for (source = 0; source < 4; source++)
+                for (i = 0; i < 16; i++)
+                    m.laneMask[lane][source][i] = m.from[16*lane + i] / 16 == source ? m.from[16*lane + i] % 16 : 0x80;
+        for (reg = 0; reg < 2; reg++)
+            for (variant = 0; variant < 4; variant++)
+                for (half = 0; half < 2; half++)
+                    for (i = 0; i < 16; i++)
+                        m.ymmMask[reg][variant][16*half + i] = m.laneMask[2*reg + half][ymmSourceLane(variant, half)][i];
+    }
+    return table;
+}
+
+static constexpr FaceMoveTable faceMoveTable = buildFaceMoveTable();
+
+
+/**********************************************************************
+**                            MOVE KERNELS                           **
+**********************************************************************/
+
+typedef void (*FaceKernel)(char* facelets, const int* moves, size_t nrMoves);
+
+static void applyMovesScalar(char* facelets, const int* moves, size_t nrMoves) {
+    char old[64];
+    size_t n;
+    unsigned i;
+
+    for (n = 0; n < nrMoves; n++) {
+        const FaceMove& m = faceMoveTable.moves[moves[n]];
+        memcpy(old, facelets, sizeof(old));
+        for (i = 0; i < NR_FACELETS; i++)
+            facelets[i] = old[m.from[i]];
+    }
+}
+
+#ifdef FACECUBE_X86
+// every destination lane ORs the bytes it takes from each of the four source lanes
+__attribute__((target("ssse3")))
+static void applyMovesSsse3(char* facelets, const int* moves, size_t nrMoves) {
+    __m128i lanes[4], next[4];
+    size_t n;
+    unsigned d, s;
+
+    for (d = 0; d < 4; d++)
+        lanes[d] = _mm_load_si128((const __m128i*) facelets + d);
+    for (n = 0; n < nrMoves; n++) {
+        const FaceMove& m = faceMoveTable.moves[moves[n]];
+        for (d = 0; d < 4; d++) {
+            next[d] = _mm_shuffle_epi8(lanes[0], _mm_load_si128((const __m128i*) m.laneMask[d][0]));
+            for (s = 1; s < 4; s++)
+                next[d] = _mm_or_si128(next[d], _mm_shuffle_epi8(lanes[s], _mm_load_si128((const __m128i*) m.laneMask[d][s])));
+        }
+        for (d = 0; d < 4; d++)
+            lanes[d] = next[d];
+    }
+    for (d = 0; d < 4; d++)
+        _mm_store_si128((__m128i*) facelets + d, lanes[d]);
+}
+
+// vpshufb stays within 128 bit lanes, the lanes are brought into place by swapping the halves of both registers
+__attribute__((target("avx2")))
+static void applyMovesAvx2(char* facelets, const int* moves, size_t nrMoves) {
+    __m256i low = _mm256_load_si256((const __m256i*) facelets);
+    __m256i high = _mm256_load_si256((const __m256i*) facelets + 1);
+    __m256i sources[4], next[2];
+    size_t n;
+    unsigned d;
+
+    for (n = 0; n < nrMoves; n++) {
+        const FaceMove& m = faceMoveTable.moves[moves[n]];
+        sources[0] = low;
+        sources[1] = _mm256_permute2x128_si256(low, low, 0x01);
+        sources[2] = high;
+        sources[3] = _mm256_permute2x128_si256(high, high, 0x01);
+        for (d = 0; d < 2; d++) {
+            next[d] = _mm256_or_si256(
+                _mm256_or_si256(_mm256_shuffle_epi8(sources[0], _mm256_load_si256((const __m256i*) m.ymmMask[d][0])),
+                                _mm256_shuffle_epi8(sources[1], _mm256_load_si256((const __m256i*) m.ymmMask[d][1]))),
+                _mm256_or_si256(_mm256_shuffle_epi8(sources[2], _mm256_load_si256((const __m256i*) m.ymmMask[d][2])),
+                                _mm256_shuffle_epi8(sources[3], _mm256_load_si256((const __m256i*) m.ymmMask[d][3]))));
+        }
+        low = next[0];
+        high = next[1];
+    }
+    _mm256_store_si256((__m256i*) facelets, low);
+    _mm256_store_si256((__m256i*) facelets + 1, high);
+}
+#endif
+
+struct FaceKernelEntry {
+    const char* name;
+    FaceKernel kernel;
+};
+
+// picks the widest kernel the cpu supports, once
+static const FaceKernelEntry& faceKernel() {
+    static const FaceKernelEntry entry = []() -> FaceKernelEntry {
+#ifdef FACECUBE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return {"avx2", applyMovesAvx2};
+        if (__builtin_cpu_supports("ssse3"))
+            return {"ssse3", applyMovesSsse3};
+#endif
+        return {"scalar", applyMovesScalar};
+    }();
+    return entry;
+}
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+FaceCube::FaceCube() {
+    reset();
+}
+
+FaceCube::FaceCube(const CubeState& state) {
+    unsigned f;
+    char colors[3];
+
+    memset(facelets, 0, sizeof(facelets));
+    for (f = 0; f < NR_FACELETS; f++) {
+        unsigned position = faceletPoint(f).position;
+        state.getColors(position % 3, position / 3 % 3, position / 9, colors);
+        facelets[f] = colors[colorIndex(position, faceletAxis(f))];
+    }
+}
+
+FaceCube::FaceCube(AlgoCube& cube) : FaceCube(cube.getState()) {}
+
+void FaceCube::reset() {
+    unsigned f;
+    memset(facelets, 0, sizeof(facelets));
+    for (f = 0; f < NR_FACELETS; f++)
+        facelets[f] = faceColors[f / 9];
+}
+
+// every face in one color, whatever the orientation of the whole cube
+bool FaceCube::isSolved() const {
+    unsigned f;
+    for (f = 0; f < NR_FACELETS; f++) {
+        if (facelets[f] != facelets[f / 9 * 9 + 4])
+            return false;
+    }
+    return true;
+}
+
+bool FaceCube::operator==(const FaceCube& other) const {
+    return memcmp(facelets, other.facelets, sizeof(facelets)) == 0;
+}
+
+bool FaceCube::operator!=(const FaceCube& other) const {
+    return !(*this == other);
+}
+
+// takes 54 color chars in facelet order, returns false if the string has another length or contains no cube color
+// facelets in the colors of faceColors, or in any six symbols (e.g. the face names URFDLB) that are then named by the
+// centers: the symbol on the center of the i-th face in the string stands for the i-th color of the solved cube
+bool FaceCube::setFacelets(const string& facelets) {
+    char symbols[6], colors[NR_FACELETS];
+    unsigned f, face;
+    const char* found;
+
+    if (facelets.size() != NR_FACELETS)
+        return false;
+    for (f = 0; f < NR_FACELETS && facelets[f] != '\0' && strchr(faceColors, facelets[f]) != NULL; f++);
+    if (f == NR_FACELETS) {
+        memcpy(this->facelets, facelets.data(), NR_FACELETS);
+        return true;
+    }
+
+    for (face = 0; face < 6; face++) {
+        symbols[face] = facelets[9*face + 4];
+        if (symbols[face] == '\0' || memchr(symbols, symbols[face], face) != NULL)
+            return false;
+    }
+    for (f = 0; f < NR_FACELETS; f++) {
+        found = facelets[f] == '\0' ? NULL : (const char*) memchr(symbols, facelets[f], 6);
+        if (found == NULL)
+            return false;
+        colors[f] = faceColors[found - symbols];
+    }
+    memcpy(this->facelets, colors, NR_FACELETS);
+    return true;
+}
+
+string FaceCube::getFacelets() const {
+    return string(facelets, NR_FACELETS);
+}
+
+// returns false if a piece does not exist or occurs twice, state is left undefined then
+bool FaceCube::toCubeState(CubeState* state) const {
+    unsigned position, axis, nrColors, slot;
+    unsigned seen[3] = {0, 0, 0};       // cubie bit sets of corners, edges and centers
+    char colors[3];
+
+    for (position = 0; position < 27; position++) {
+        unsigned x = position % 3, y = position / 3 % 3, z = position / 9;
+        nrColors = 0;
+        for (axis = 0; axis < 3; axis++) {
+            if (positionFacelets.facelet[position][axis] != NR_FACELETS) {
+                colors[colorIndex(position, axis)] = facelets[positionFacelets.facelet[position][axis]];
+                nrColors++;
+            }
+        }
+        if (nrColors == 0)
+            continue;
+        if (!state->setColors(x, y, z, colors, nrColors))
+            return false;
+    }
+
+    // every cubie exactly once
+
+    for (slot = 0; slot < 8; slot++)
+        seen[0] |= 1 << state->cornerPerm(slot);
+    for (slot = 0; slot < 12; slot++)
+        seen[1] |= 1 << state->edgePerm(slot);
+    for (slot = 0; slot < 6; slot++)
+        seen[2] |= 1 << state->centers[slot];
+    return seen[0] == 0xff && seen[1] == 0xfff && seen[2] == 0x3f;
+}
+
+bool FaceCube::toAlgoCube(AlgoCube* cube) const {
+    CubeState state;
+    if (!toCubeState(&state))
+        return false;
+    cube->setState(state);
+    return true;
+}
+
+// applies one of the 24 move codes (see movetable.h), runs of moves should go through applyMoves
+void FaceCube::applyMove(int move) {
+    faceKernel().kernel(facelets, &move, 1);
+}
+
+void FaceCube::applyMoves(const vector<int>& moves) {
+    faceKernel().kernel(facelets, moves.data(), moves.size());
+}
+
+void FaceCube::applyMoves(const int* moves, size_t nrMoves) {
+    faceKernel().kernel(facelets, moves, nrMoves);
+}
+
+// name of the move kernel chosen for this cpu ("avx2", "ssse3" or "scalar")
+const char* FaceCube::getKernelName() {
+    return faceKernel().name;
+}
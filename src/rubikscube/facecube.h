@@ -0,0 +1,52 @@
+// header file for facecube.cc
+
+#ifndef FACECUBE_H
+#define FACECUBE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <string>
+#include "cubestate.h"
+#include "rubikscube.h"
+
+using namespace std;
+
+const int NR_FACELETS = 54;
+
+class alignas(32) FaceCube {
+public:
+    /***************************************************************
+    ** Sticker level state of the cube, one color char per        **
+    ** facelet. Faces are stored in the order U R F D L B         **
+    ** (top, right, front, bottom, left, back), each face row by  **
+    ** row as seen from outside with                              **
+    **   U -- back row first, F -- top row first,                 **
+    **   R, B, L -- top row first, D -- front row first           **
+    ** (the usual unfolded net with F in the middle). The bytes   **
+    ** behind the 54 facelets are padding and stay zero, so the   **
+    ** state fills exactly four 16 byte lanes.                    **
+    ***************************************************************/
+    char facelets[64];
+
+    FaceCube();
+    explicit FaceCube(const CubeState& state);
+    explicit FaceCube(AlgoCube& cube);
+    void reset();
+    bool isSolved() const;
+    bool operator==(const FaceCube& other) const;
+    bool operator!=(const FaceCube& other) const;
+
+    bool setFacelets(const string& facelets);
+    string getFacelets() const;
+    bool toCubeState(CubeState* state) const;
+    bool toAlgoCube(AlgoCube* cube) const;
+
+    void applyMove(int move);
+    void applyMoves(const vector<int>& moves);
+    void applyMoves(const int* moves, size_t nrMoves);
+
+    static const char* getKernelName();
+};
+
+#endif
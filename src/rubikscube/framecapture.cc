@@ -0,0 +1,167 @@
+/* standard includes */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "framecapture.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+FrameCapture::FrameCapture() {
+    writer = NULL;
+    width = 0;
+    height = 0;
+    issued = 0;
+    copied = 0;
+    written = 0;
+    finishing = false;
+    failed = false;
+    seconds = 0;
+    for (unsigned i = 0; i < CAPTURE_RING_SIZE; i++)
+        pixelBuffers[i] = 0;
+}
+
+FrameCapture::~FrameCapture() {
+    if (writer != NULL)
+        finish();
+}
+
+// needs the GL context of the render loop, frames go to writer (which has to be open)
+bool FrameCapture::open(FrameWriter* writer, unsigned width, unsigned height) {
+    size_t frameSize = (size_t) width * height * 3;
+    unsigned i;
+
+    this->writer = writer;
+    this->width = width;
+    this->height = height;
+    issued = 0;
+    copied = 0;
+    written = 0;
+    finishing = false;
+    failed = false;
+    seconds = 0;
+
+    glGenBuffers(CAPTURE_RING_SIZE, pixelBuffers);
+    for (i = 0; i < CAPTURE_RING_SIZE; i++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameSize, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    frames.assign(CAPTURE_QUEUE_SIZE, vector<uint8_t>(frameSize));
+    freeFrames.clear();
+    queue.clear();
+    for (i = 0; i < CAPTURE_QUEUE_SIZE; i++)
+        freeFrames.push_back(i);
+
+    startTime = chrono::steady_clock::now();
+    worker = thread(&FrameCapture::run, this);
+    return true;
+}
+
+// starts reading the frame in GL_READ_FRAMEBUFFER, copies out the one read CAPTURE_RING_SIZE - 1 frames ago
+bool FrameCapture::capture() {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[issued % CAPTURE_RING_SIZE]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    issued++;
+
+    if (issued - copied == CAPTURE_RING_SIZE)
+        return copyOldest();
+    return true;
+}
+
+// maps the oldest read of the ring into a free frame and queues it, waits while the queue is full
+bool FrameCapture::copyOldest() {
+    size_t frameSize = (size_t) width * height * 3;
+    const void* pixels;
+    unsigned frame;
+
+    {
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [this]() { return failed || !freeFrames.empty(); });
+        if (failed)
+            return false;
+        frame = freeFrames.back();
+        freeFrames.pop_back();
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[copied % CAPTURE_RING_SIZE]);
+    pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameSize, GL_MAP_READ_BIT);
+    if (pixels != NULL) {
+        memcpy(&frames[frame][0], pixels, frameSize);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    copied++;
+
+    {
+        lock_guard<mutex> guard(lock);
+        if (pixels == NULL) {
+            fprintf(stderr, "Error: cannot map the pixel buffer of frame %llu\n", (unsigned long long) copied - 1);
+            failed = true;
+            freeFrames.push_back(frame);
+        } else {
+            queue.push_back(frame);
+        }
+    }
+    changed.notify_all();
+    return pixels != NULL;
+}
+
+void FrameCapture::run() {
+    unsigned frame;
+    bool ok;
+
+    for (;;) {
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait(guard, [this]() { return !queue.empty() || finishing || failed; });
+            if (queue.empty() || failed)
+                return;
+            frame = queue.front();
+            queue.pop_front();
+        }
+
+        ok = writer->writeFrame(&frames[frame][0], true);
+
+        {
+            lock_guard<mutex> guard(lock);
+            freeFrames.push_back(frame);
+            if (ok)
+                written++;
+            else
+                failed = true;
+        }
+        changed.notify_all();
+    }
+}
+
+// copies out the reads still in the ring, waits for the writer and frees the pixel buffers, false if a frame was lost
+bool FrameCapture::finish() {
+    bool ok = true;
+
+    if (writer == NULL)
+        return false;
+    while (ok && copied < issued)
+        ok = copyOldest();
+
+    {
+        lock_guard<mutex> guard(lock);
+        finishing = true;
+    }
+    changed.notify_all();
+    worker.join();
+
+    glDeleteBuffers(CAPTURE_RING_SIZE, pixelBuffers);
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    writer = NULL;
+    return ok && !failed;
+}
@@ -0,0 +1,71 @@
+// header file for framecapture.cc
+
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <stdint.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/* We use glew.h instead of gl.h to get all the GL prototypes declared */
+#include <GL/glew.h>
+#include "framewriter.h"
+
+using namespace std;
+
+const unsigned CAPTURE_RING_SIZE = 3;      // frame N is copied out while N+2 is drawn
+const unsigned CAPTURE_QUEUE_SIZE = 8;     // frames waiting for the writer at most
+
+class FrameCapture {
+private:
+    /***************************************************************
+    ** Reads the frames of the render loop without stalling it:  **
+    ** every frame is read into the next pixel buffer object of   **
+    ** a ring (the GPU copies while the loop goes on) and only    **
+    ** mapped two frames later. The pixels go through a bounded   **
+    ** queue to a worker thread that encodes and writes them, a   **
+    ** full queue holds the render loop back.                     **
+    ***************************************************************/
+    FrameWriter* writer;
+    unsigned width;
+    unsigned height;
+    GLuint pixelBuffers[CAPTURE_RING_SIZE];
+    uint64_t issued;            // reads started
+    uint64_t copied;            // reads copied out of the ring
+    uint64_t written;
+
+    thread worker;
+    mutex lock;
+    condition_variable changed;
+    vector<vector<uint8_t> > frames;
+    deque<unsigned> queue;      // frames waiting for the writer
+    vector<unsigned> freeFrames;
+    bool finishing;
+    bool failed;
+
+    chrono::steady_clock::time_point startTime;
+    double seconds;
+
+    FrameCapture(const FrameCapture&);
+    FrameCapture& operator=(const FrameCapture&);
+
+    bool copyOldest();
+    void run();
+
+public:
+    FrameCapture();
+    ~FrameCapture();
+
+    bool open(FrameWriter* writer, unsigned width, unsigned height);
+    bool capture();
+    bool finish();
+    uint64_t getFrames() const { return written; }
+    double getSeconds() const { return seconds; }
+    double getFramesPerSecond() const { return seconds > 0 ? written / seconds : 0; }
+};
+
+#endif
@@ -0,0 +1,234 @@
+/* standard includes */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include "framewriter.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+struct CrcTable {
+    uint32_t entry[256];
+};
+
+constexpr CrcTable buildCrcTable() {
+    CrcTable table = {};
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (unsigned k = 0; k < 8; k++)
+            c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        table.entry[n] = c;
+    }
+    return table;
+}
+
+static constexpr CrcTable crcTable = buildCrcTable();
+
+static uint32_t updateCrc(uint32_t crc, const uint8_t* data, size_t size) {
+    size_t i;
+    for (i = 0; i < size; i++)
+        crc = crcTable.entry[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+static void putBigEndian(vector<uint8_t>* out, uint32_t value) {
+    out->push_back(value >> 24);
+    out->push_back(value >> 16 & 0xff);
+    out->push_back(value >> 8 & 0xff);
+    out->push_back(value & 0xff);
+}
+
+// appends a PNG chunk: length, type, data, CRC over type and data
+static void putChunk(vector<uint8_t>* out, const char* type, const uint8_t* data, size_t size) {
+    size_t start;
+
+    putBigEndian(out, size);
+    start = out->size();
+    out->insert(out->end(), type, type + 4);
+    out->insert(out->end(), data, data + size);
+    putBigEndian(out, updateCrc(0xffffffffu, &(*out)[start], size + 4) ^ 0xffffffffu);
+}
+
+// studio range BT.601, what players assume for y4m without a color range tag
+static uint8_t toY(int r, int g, int b) {
+    return ((66*r + 129*g + 25*b + 128) >> 8) + 16;
+}
+
+static uint8_t toU(int r, int g, int b) {
+    return ((-38*r - 74*g + 112*b + 128) >> 8) + 128;
+}
+
+static uint8_t toV(int r, int g, int b) {
+    return ((112*r - 94*g - 18*b + 128) >> 8) + 128;
+}
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+FrameWriter::FrameWriter() {
+    stream = NULL;
+    width = 0;
+    height = 0;
+    fps = 0;
+    frames = 0;
+}
+
+FrameWriter::~FrameWriter() {
+    close();
+}
+
+// width and height have to be even for the y4m chroma planes
+bool FrameWriter::open(const string& path, unsigned width, unsigned height, unsigned fps) {
+    bool y4m = path == "-" || (path.size() > 4 && path.compare(path.size() - 4, 4, ".y4m") == 0);
+
+    close();
+    this->width = width;
+    this->height = height;
+    this->fps = fps;
+    frames = 0;
+
+    if (!y4m) {
+        pngPrefix = path;
+        return true;
+    }
+    if (width % 2 != 0 || height % 2 != 0) {
+        fprintf(stderr, "Error: y4m frames need an even size, not %ux%u\n", width, height);
+        return false;
+    }
+    stream = path == "-" ? stdout : fopen(path.c_str(), "wb");
+    if (stream == NULL) {
+        fprintf(stderr, "Error: cannot write %s\n", path.c_str());
+        return false;
+    }
+    fprintf(stream, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n", width, height, fps);
+    return true;
+}
+
+void FrameWriter::close() {
+    if (stream != NULL && stream != stdout)
+        fclose(stream);
+    else if (stream != NULL)
+        fflush(stream);
+    stream = NULL;
+    pngPrefix.clear();
+}
+
+// rgb holds width*height pixels of 3 bytes, bottomUp for rows as glReadPixels returns them
+bool FrameWriter::writeFrame(const uint8_t* rgb, bool bottomUp) {
+    bool written = stream != NULL ? writeY4mFrame(rgb, bottomUp) : writePngFrame(rgb, bottomUp);
+    if (written)
+        frames++;
+    return written;
+}
+
+bool FrameWriter::writeY4mFrame(const uint8_t* rgb, bool bottomUp) {
+    unsigned x, y, row, dx, dy;
+    size_t lumaSize = (size_t) width * height;
+    uint8_t* luma;
+    uint8_t* u;
+    uint8_t* v;
+
+    buffer.resize(lumaSize * 3 / 2);
+    luma = &buffer[0];
+    u = luma + lumaSize;
+    v = u + lumaSize / 4;
+    for (y = 0; y < height; y++) {
+        row = bottomUp ? height - 1 - y : y;
+        for (x = 0; x < width; x++) {
+            const uint8_t* pixel = rgb + ((size_t) row * width + x) * 3;
+            luma[(size_t) y * width + x] = toY(pixel[0], pixel[1], pixel[2]);
+        }
+    }
+    // chroma of the average of every 2x2 block
+    for (y = 0; y < height; y += 2) {
+        for (x = 0; x < width; x += 2) {
+            int r = 0, g = 0, b = 0;
+            for (dy = 0; dy < 2; dy++) {
+                row = bottomUp ? height - 1 - (y + dy) : y + dy;
+                for (dx = 0; dx < 2; dx++) {
+                    const uint8_t* pixel = rgb + ((size_t) row * width + x + dx) * 3;
+                    r += pixel[0];
+                    g += pixel[1];
+                    b += pixel[2];
+                }
+            }
+            u[(size_t) y / 2 * (width / 2) + x / 2] = toU(r / 4, g / 4, b / 4);
+            v[(size_t) y / 2 * (width / 2) + x / 2] = toV(r / 4, g / 4, b / 4);
+        }
+    }
+
+    if (fputs("FRAME\n", stream) < 0 || fwrite(&buffer[0], 1, buffer.size(), stream) != buffer.size()) {
+        fprintf(stderr, "Error: cannot write frame %llu\n", (unsigned long long) frames);
+        return false;
+    }
+    return true;
+}
+
+// zlib stream of stored deflate blocks (at most 65535 bytes each) of the filtered rows (filter 0)
+bool FrameWriter::writePngFrame(const uint8_t* rgb, bool bottomUp) {
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    vector<uint8_t> raw, idat, header;
+    size_t rowSize = (size_t) width * 3, offset, block;
+    uint32_t adlerA = 1, adlerB = 0;
+    unsigned y, row;
+    size_t i;
+    char path[4096];
+    FILE* file;
+
+    raw.reserve((rowSize + 1) * height);
+    for (y = 0; y < height; y++) {
+        row = bottomUp ? height - 1 - y : y;
+        raw.push_back(0);
+        raw.insert(raw.end(), rgb + row * rowSize, rgb + (row + 1) * rowSize);
+    }
+    for (i = 0; i < raw.size(); i++) {
+        adlerA = (adlerA + raw[i]) % 65521;
+        adlerB = (adlerB + adlerA) % 65521;
+    }
+
+    idat.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    for (offset = 0; offset < raw.size(); offset += block) {
+        block = raw.size() - offset < 65535 ? raw.size() - offset : 65535;
+        idat.push_back(offset + block == raw.size() ? 1 : 0);
+        idat.push_back(block & 0xff);
+        idat.push_back(block >> 8);
+        idat.push_back(~block & 0xff);
+        idat.push_back(~block >> 8 & 0xff);
+        idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + block);
+    }
+    putBigEndian(&idat, adlerB << 16 | adlerA);
+
+    putBigEndian(&header, width);
+    putBigEndian(&header, height);
+    header.push_back(8);        // bits per channel
+    header.push_back(2);        // RGB
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+
+    buffer.assign(signature, signature + 8);
+    putChunk(&buffer, "IHDR", &header[0], header.size());
+    putChunk(&buffer, "IDAT", &idat[0], idat.size());
+    putChunk(&buffer, "IEND", NULL, 0);
+
+    snprintf(path, sizeof(path), "%s%05llu.png", pngPrefix.c_str(), (unsigned long long) frames);
+    file = fopen(path, "wb");
+    if (file == NULL || fwrite(&buffer[0], 1, buffer.size(), file) != buffer.size()) {
+        fprintf(stderr, "Error: cannot write %s\n", path);
+        if (file != NULL)
+            fclose(file);
+        return false;
+    }
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,46 @@
+// header file for framewriter.cc
+
+#ifndef FRAMEWRITER_H
+#define FRAMEWRITER_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+class FrameWriter {
+private:
+    /***************************************************************
+    ** Writes rendered RGB frames either as one raw YUV4MPEG2     **
+    ** stream (4:2:0, path ending in .y4m or - for stdout, e.g.   **
+    ** for ffmpeg) or as numbered PNG files path00000.png, ...    **
+    ** The PNGs are stored without compression, so no zlib is     **
+    ** needed and writing never costs more than the copy.         **
+    ***************************************************************/
+    FILE* stream;               // y4m stream, NULL for PNG files
+    string pngPrefix;
+    unsigned width;
+    unsigned height;
+    unsigned fps;
+    uint64_t frames;
+    vector<uint8_t> buffer;
+
+    FrameWriter(const FrameWriter&);
+    FrameWriter& operator=(const FrameWriter&);
+
+    bool writeY4mFrame(const uint8_t* rgb, bool bottomUp);
+    bool writePngFrame(const uint8_t* rgb, bool bottomUp);
+
+public:
+    FrameWriter();
+    ~FrameWriter();
+
+    bool open(const string& path, unsigned width, unsigned height, unsigned fps);
+    bool writeFrame(const uint8_t* rgb, bool bottomUp=false);
+    void close();
+    uint64_t getFrames() const { return frames; }
+};
+
+#endif
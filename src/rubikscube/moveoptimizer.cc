@@ -0,0 +1,163 @@
+/* standard includes */
+#include <stdint.h>
+#include <vector>
+#include "moveoptimizer.h"
+#include "movetable.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+struct SpinConjugateTable {
+    // layer move m2 with: spin, m == m2, spin (0 for the spins themselves)
+    int8_t move[6][NR_MOVES];
+};
+
+constexpr bool isSameTurn(const uint8_t* from, int move) {
+    for (unsigned position = 0; position < 27; position++) {
+        if (from[position] != positionMoveTable.from[move][position])
+            return false;
+    }
+    return true;
+}
+
+constexpr SpinConjugateTable buildSpinConjugateTable() {
+    SpinConjugateTable table = {};
+    for (int spin = 0; spin < 6; spin++) {
+        for (int move = 6; move < NR_MOVES; move++) {
+            uint8_t from[27] = {};
+            // spin, move, inverse spin
+            for (unsigned position = 0; position < 27; position++)
+                from[position] = positionMoveTable.from[spin][positionMoveTable.from[move][positionMoveTable.from[inverseMove(spin)][position]]];
+            for (int candidate = 6; candidate < NR_MOVES; candidate++) {
+                if (isSameTurn(from, candidate))
+                    table.move[spin][move] = candidate;
+            }
+        }
+    }
+    return table;
+}
+
+constexpr SpinConjugateTable spinConjugateTable = buildSpinConjugateTable();
+
+// quarter turns of the three layers of one axis, mod 4
+struct MoveRun {
+    unsigned axis;
+    unsigned turns[3];
+};
+
+// codes needed to emit a net number of quarter turns
+static unsigned turnCost(unsigned turns) {
+    return turns == 0 ? 0 : turns == 2 ? 2 : 1;
+}
+
+// shortest sequence of spins whose positions match orientation
+static void appendSpins(const uint8_t* orientation, vector<int>* moves) {
+    unsigned length, total, sequence, rest, i, p;
+    int spins[4];
+
+    for (length = 0, total = 1; length <= 4; length++, total *= 6) {
+        for (sequence = 0; sequence < total; sequence++) {
+            uint8_t from[27];
+            for (p = 0; p < 27; p++)
+                from[p] = p;
+            for (i = 0, rest = sequence; i < length; i++, rest /= 6) {
+                spins[i] = rest % 6;
+                uint8_t previous[27];
+                for (p = 0; p < 27; p++)
+                    previous[p] = from[p];
+                for (p = 0; p < 27; p++)
+                    from[p] = previous[positionMoveTable.from[spins[i]][p]];
+            }
+            for (p = 0; p < 27 && from[p] == orientation[p]; p++);
+            if (p == 27) {
+                moves->insert(moves->end(), spins, spins + length);
+                return;
+            }
+        }
+    }
+}
+
+
+/**********************************************************************
+**                        FUNCTION DEFINITIONS                       **
+**********************************************************************/
+
+void optimizeMoves(vector<int>* moves) {
+    vector<MoveRun> runs;
+    int relabel[NR_MOVES];          // layer move of the output for a layer move of the input
+    int previousRelabel[NR_MOVES];
+    uint8_t orientation[27];        // positions of the spins held back, see appendSpins
+    uint8_t previous[27];
+    unsigned axis, layer, best, bestCost, cost, k, i, p;
+    int move, code, spin;
+
+    for (move = 0; move < NR_MOVES; move++)
+        relabel[move] = move;
+    for (p = 0; p < 27; p++)
+        orientation[p] = p;
+
+    for (i = 0; i < moves->size(); i++) {
+        move = (*moves)[i];
+        if (move < 6) {
+            // the spin happens after everything emitted so far and the spins held back
+            for (code = 6; code < NR_MOVES; code++)
+                previousRelabel[code] = relabel[code];
+            for (code = 6; code < NR_MOVES; code++)
+                relabel[code] = previousRelabel[spinConjugateTable.move[move][code]];
+            for (p = 0; p < 27; p++)
+                previous[p] = orientation[p];
+            for (p = 0; p < 27; p++)
+                orientation[p] = previous[positionMoveTable.from[move][p]];
+            continue;
+        }
+
+        move = relabel[move];
+        axis = moveAxis(move);
+        layer = moveLayer(move);
+        if (runs.empty() || runs.back().axis != axis) {
+            MoveRun run = {axis, {0, 0, 0}};
+            runs.push_back(run);
+        }
+        MoveRun& run = runs.back();
+        run.turns[layer] = (run.turns[layer] + (isReverseMove(move) ? 3 : 1)) % 4;
+
+        // turning all three layers k times is k spins, which go in front of the spins held back
+        best = 0;
+        bestCost = 5;
+        for (k = 0; k < 4; k++) {
+            cost = turnCost((run.turns[0] + 4 - k) % 4) + turnCost((run.turns[1] + 4 - k) % 4) + turnCost((run.turns[2] + 4 - k) % 4);
+            if (cost < bestCost) {
+                best = k;
+                bestCost = cost;
+            }
+        }
+        spin = moveCode(axis, -1, false);
+        for (k = 0; k < best; k++) {
+            for (layer = 0; layer < 3; layer++)
+                run.turns[layer] = (run.turns[layer] + 3) % 4;
+            for (code = 6; code < NR_MOVES; code++)
+                relabel[code] = spinConjugateTable.move[spin][relabel[code]];
+            for (p = 0; p < 27; p++)
+                previous[p] = orientation[p];
+            for (p = 0; p < 27; p++)
+                orientation[p] = positionMoveTable.from[spin][previous[p]];
+        }
+        if (bestCost == 0)
+            runs.pop_back();
+    }
+
+    moves->clear();
+    for (i = 0; i < runs.size(); i++) {
+        for (layer = 0; layer < 3; layer++) {
+            if (runs[i].turns[layer] == 3)
+                moves->push_back(moveCode(runs[i].axis, layer, true));
+            else
+                moves->insert(moves->end(), runs[i].turns[layer], moveCode(runs[i].axis, layer, false));
+        }
+    }
+    appendSpins(orientation, moves);
+}
@@ -0,0 +1,25 @@
+// header file for moveoptimizer.cc
+
+#ifndef MOVEOPTIMIZER_H
+#define MOVEOPTIMIZER_H
+
+#include <vector>
+
+using namespace std;
+
+/***************************************************************
+** Peephole pass over a stream of move codes (movetable.h)    **
+** that leaves the cube in exactly the same state:            **
+** -- whole cube spins are moved behind the layer turns by    **
+**    relabeling the turns after them, at the end the fewest  **
+**    spins reaching the same orientation are appended        **
+** -- turns along the same axis commute, so each run of them  **
+**    is reduced to its net quarter turns per layer, runs     **
+**    cancelling out entirely let their neighbours merge      **
+** -- equal net turns of all three layers of a run become a   **
+**    spin, which costs nothing until the end                 **
+** Half turns stay two codes like everywhere else.            **
+***************************************************************/
+void optimizeMoves(vector<int>* moves);
+
+#endif
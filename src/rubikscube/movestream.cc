@@ -0,0 +1,320 @@
+/* standard includes */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "movestream.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+struct SpinConjugates {
+    // every move turned along with a spin: spin, move, inverse spin as one move code, for the spins too
+    uint8_t moves[6][NR_MOVES];
+};
+
+static constexpr bool isSamePermutation(const uint8_t* from, int move) {
+    for (unsigned position = 0; position < 27; position++) {
+        if (from[position] != positionMoveTable.from[move][position])
+            return false;
+    }
+    return true;
+}
+
+static constexpr SpinConjugates buildSpinConjugates() {
+    SpinConjugates table = {};
+    for (int spin = 0; spin < 6; spin++) {
+        for (int move = 0; move < NR_MOVES; move++) {
+            uint8_t from[27] = {};
+            for (unsigned position = 0; position < 27; position++)
+                from[position] = positionMoveTable.from[spin][positionMoveTable.from[move][positionMoveTable.from[inverseMove(spin)][position]]];
+            for (int candidate = 0; candidate < NR_MOVES; candidate++) {
+                if (isSamePermutation(from, candidate))
+                    table.moves[spin][move] = candidate;
+            }
+        }
+    }
+    return table;
+}
+
+// the 24 orientations breadth first from the identity, each spin relabeling the moves of the ones found before
+static constexpr MoveOrientationTable buildMoveOrientationTable() {
+    constexpr SpinConjugates spins = buildSpinConjugates();
+    MoveOrientationTable table = {};
+    unsigned nrOrientations = 1;
+
+    for (unsigned move = 0; move < NR_MOVES; move++)
+        table.moves[0][move] = move;
+    for (unsigned orientation = 0; orientation < nrOrientations; orientation++) {
+        for (int spin = 0; spin < 6 && nrOrientations < NR_ORIENTATIONS; spin++) {
+            uint8_t next[NR_MOVES] = {};
+            unsigned known = 0, move = 0;
+            for (move = 0; move < NR_MOVES; move++)
+                next[move] = spins.moves[spin][table.moves[orientation][move]];
+            for (known = 0; known < nrOrientations; known++) {
+                for (move = 0; move < NR_MOVES && table.moves[known][move] == next[move]; move++)
+                    ;
+                if (move == NR_MOVES)
+                    break;
+            }
+            if (known == nrOrientations) {
+                for (move = 0; move < NR_MOVES; move++)
+                    table.moves[nrOrientations][move] = next[move];
+                nrOrientations++;
+            }
+        }
+    }
+    return table;
+}
+
+// the last layer algorithms of AlgoCube in move codes, f r u r' u' f' of buildYellowCross first
+static MoveDictionary makeLayerByLayerDictionary() {
+    const int yellowCross[] = {12, 8, 20, 11, 23, 15};          // f r u r' u' f'
+    const int sune[] = {8, 20, 20, 11, 23, 8, 23, 11};          // r u u r' u' r u' r'
+    const int cornerCycle[] = {6, 20, 8, 23, 9, 20, 11, 23};    // l' u r u' l u r' u'
+    const int leftSune[] = {6, 20, 20, 9, 20, 6, 20, 9};        // l' u u l u l' u l
+    MoveDictionary dictionary;
+
+    dictionary.add(yellowCross, 6);
+    dictionary.add(sune, 8);
+    dictionary.add(cornerCycle, 8);
+    dictionary.add(leftSune, 8);
+    return dictionary;
+}
+
+// number of symbols the moves take, greedy: the longest word that fits in any orientation, else the move itself
+static size_t countSymbols(const int* moves, size_t count, const MoveDictionary* dictionary) {
+    size_t nrSymbols = 0, i;
+    unsigned length, orientation;
+
+    for (i = 0; i < count; ) {
+        if (dictionary != NULL
+            && dictionary->match(moves + i, count - i, &length, &orientation) < MAX_DICTIONARY_WORDS) {
+            i += length;
+            nrSymbols += 2;
+        } else {
+            i++;
+            nrSymbols++;
+        }
+    }
+    return nrSymbols;
+}
+
+static void appendSymbol(unsigned symbol, uint32_t* bits, unsigned* nrBits, vector<uint8_t>* stream) {
+    *bits |= symbol << *nrBits;
+    *nrBits += MOVE_SYMBOL_BITS;
+    if (*nrBits >= 8) {
+        stream->push_back((uint8_t) *bits);
+        *bits >>= 8;
+        *nrBits -= 8;
+    }
+}
+
+
+/**********************************************************************
+**                        FUNCTION DEFINITIONS                       **
+**********************************************************************/
+
+// appends one record and returns its size in bytes, the moves have to be move codes (0 to NR_MOVES - 1)
+size_t encodeMoves(const int* moves, size_t count, vector<uint8_t>* stream, const MoveDictionary* dictionary) {
+    size_t start = stream->size();
+    size_t nrSymbols = countSymbols(moves, count, dictionary);
+    size_t value, i;
+    uint32_t bits = 0;
+    unsigned nrBits = 0, length, word, orientation;
+
+    for (value = nrSymbols; value >= 128; value >>= 7)
+        stream->push_back((uint8_t) (value | 128));
+    stream->push_back((uint8_t) value);
+
+    for (i = 0; i < count; ) {
+        word = MAX_DICTIONARY_WORDS;
+        if (dictionary != NULL)
+            word = dictionary->match(moves + i, count - i, &length, &orientation);
+        if (word < MAX_DICTIONARY_WORDS) {
+            appendSymbol(NR_MOVES + word, &bits, &nrBits, stream);
+            appendSymbol(orientation, &bits, &nrBits, stream);
+            i += length;
+        } else {
+            appendSymbol(moves[i], &bits, &nrBits, stream);
+            i++;
+        }
+    }
+    if (nrBits > 0)
+        stream->push_back((uint8_t) bits);
+    return stream->size() - start;
+}
+
+size_t encodeMoves(const vector<int>& moves, vector<uint8_t>* stream, const MoveDictionary* dictionary) {
+    return encodeMoves(moves.data(), moves.size(), stream, dictionary);
+}
+
+extern constexpr MoveOrientationTable moveOrientationTable = buildMoveOrientationTable();
+
+const MoveDictionary& getLayerByLayerDictionary() {
+    static const MoveDictionary dictionary = makeLayerByLayerDictionary();
+    return dictionary;
+}
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+MoveDictionary::MoveDictionary() {
+    memset(words, 0, sizeof(words));
+    memset(lengths, 0, sizeof(lengths));
+    nrWords = 0;
+}
+
+// false if the dictionary is full or the word is no sequence of move codes of 3 to MAX_WORD_LENGTH moves (two
+// moves take as many bits as the word and its orientation)
+bool MoveDictionary::add(const int* moves, unsigned length) {
+    unsigned i;
+
+    if (nrWords == MAX_DICTIONARY_WORDS || length < 3 || length > MAX_WORD_LENGTH)
+        return false;
+    for (i = 0; i < length; i++) {
+        if (moves[i] < 0 || moves[i] >= NR_MOVES)
+            return false;
+        words[nrWords][i] = moves[i];
+    }
+    lengths[nrWords] = length;
+    nrWords++;
+    return true;
+}
+
+// the longest word the moves start with in any orientation (its length in *length, the orientation in
+// *orientation), MAX_DICTIONARY_WORDS if none
+unsigned MoveDictionary::match(const int* moves, size_t count, unsigned* length, unsigned* orientation) const {
+    unsigned best = MAX_DICTIONARY_WORDS, bestLength = 0, bestOrientation = 0, word, turned, i;
+
+    for (word = 0; word < nrWords; word++) {
+        if (lengths[word] <= bestLength || lengths[word] > count)
+            continue;
+        for (turned = 0; turned < NR_ORIENTATIONS; turned++) {
+            const uint8_t* relabel = moveOrientationTable.moves[turned];
+            for (i = 0; i < lengths[word] && moves[i] == relabel[words[word][i]]; i++)
+                ;
+            if (i == lengths[word]) {
+                best = word;
+                bestLength = i;
+                bestOrientation = turned;
+                break;
+            }
+        }
+    }
+    *length = bestLength;
+    *orientation = bestOrientation;
+    return best;
+}
+
+size_t MoveSequence::getNrMoves() const {
+    size_t nrMoves = 0, i;
+    unsigned value;
+
+    for (i = 0; i < nrSymbols; i++) {
+        value = getSymbol(i);
+        if (value < (unsigned) NR_MOVES) {
+            nrMoves++;
+        } else {
+            nrMoves += dictionary->getLength(value - NR_MOVES);
+            i++;
+        }
+    }
+    return nrMoves;
+}
+
+void MoveSequence::decode(vector<int>* moves) const {
+    Iterator move = begin();
+
+    moves->clear();
+    for (; move != end(); ++move)
+        moves->push_back(*move);
+}
+
+MoveStreamReader::MoveStreamReader(const uint8_t* data, size_t size, const MoveDictionary* dictionary) {
+    this->data = data;
+    this->size = size;
+    this->dictionary = dictionary;
+    offset = 0;
+    damaged = false;
+}
+
+// the next record, false at the end of the data or of a complete record, or if the record is damaged (then isDamaged
+// is true and the reader stays there). Symbols of words are checked here, so iterating a record needs no checks.
+bool MoveStreamReader::next(MoveSequence* sequence) {
+    size_t position = offset, nrSymbols = 0, i;
+    unsigned shift = 0, value;
+    uint8_t byte;
+
+    if (damaged)
+        return false;
+    do {
+        if (position == size)
+            return false;
+        if (shift > 56) {
+            damaged = true;
+            return false;
+        }
+        byte = data[position++];
+        nrSymbols |= (size_t) (byte & 127) << shift;
+        shift += 7;
+    } while (byte & 128);
+
+    if (nrSymbols > (size - position) * 8 / MOVE_SYMBOL_BITS)
+        return false;
+    *sequence = MoveSequence(data + position, nrSymbols, dictionary);
+    for (i = 0; i < nrSymbols; i++) {
+        value = sequence->getSymbol(i);
+        if (value < (unsigned) NR_MOVES)
+            continue;
+        if (dictionary == NULL || value - NR_MOVES >= dictionary->getNrWords() || ++i == nrSymbols
+            || sequence->getSymbol(i) >= NR_ORIENTATIONS) {
+            damaged = true;
+            return false;
+        }
+    }
+    offset = position + sequence->getPackedSize();
+    return true;
+}
+
+MoveStreamWriter::MoveStreamWriter(FILE* file, const MoveDictionary* dictionary) {
+    this->file = file;
+    this->dictionary = dictionary;
+    nrSolutions = 0;
+    nrMoves = 0;
+    nrBytes = 0;
+    failed = false;
+    buffer.reserve(MOVE_STREAM_BUFFER);
+}
+
+// the file stays open, it belongs to the caller
+MoveStreamWriter::~MoveStreamWriter() {
+    flush();
+}
+
+bool MoveStreamWriter::write(const int* moves, size_t count) {
+    if (failed)
+        return false;
+    nrBytes += encodeMoves(moves, count, &buffer, dictionary);
+    nrSolutions++;
+    nrMoves += count;
+    return buffer.size() < MOVE_STREAM_BUFFER || flush();
+}
+
+bool MoveStreamWriter::flush() {
+    if (failed)
+        return false;
+    if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        fprintf(stderr, "Error: cannot write the move stream\n");
+        failed = true;
+        return false;
+    }
+    buffer.clear();
+    return fflush(file) == 0;
+}
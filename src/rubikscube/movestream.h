@@ -0,0 +1,194 @@
+// header file for movestream.cc
+
+#ifndef MOVESTREAM_H
+#define MOVESTREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <vector>
+#include "movetable.h"
+
+using namespace std;
+
+const unsigned MOVE_SYMBOL_BITS = 5;
+const unsigned NR_MOVE_SYMBOLS = 1 << MOVE_SYMBOL_BITS;
+const unsigned MAX_DICTIONARY_WORDS = NR_MOVE_SYMBOLS - NR_MOVES;   // symbols 24-31
+const unsigned MAX_WORD_LENGTH = 16;
+const unsigned NR_ORIENTATIONS = 24;        // of the whole cube, the symbol after a word
+const size_t MOVE_STREAM_BUFFER = 1 << 16;  // bytes MoveStreamWriter collects before they go to the file
+
+/***************************************************************
+** Packed move stream, a sequence of records, one per         **
+** solution:                                                  **
+**   symbol count -- unsigned LEB128 (one byte below 128)     **
+**   symbols      -- 5 bits each, the first in the low bits   **
+**                   of the first byte, the last byte filled  **
+**                   up with zero bits                        **
+** Symbols below NR_MOVES are move codes (see movetable.h),   **
+** the others words of the dictionary the stream was written  **
+** with. Each word is followed by a symbol with the           **
+** orientation of the whole cube it is turned in (see         **
+** moveOrientationTable), as solutions relabel their turns    **
+** after every spin (optimizeMoves). Records are byte         **
+** aligned, the stream is the same on every host.             **
+***************************************************************/
+
+// move codes of every move in each orientation of the whole cube, 0 is the move itself. The order of the
+// orientations is part of the stream format.
+struct MoveOrientationTable {
+    uint8_t moves[NR_ORIENTATIONS][NR_MOVES];
+};
+
+extern const MoveOrientationTable moveOrientationTable;
+
+class MoveDictionary {
+private:
+    /***************************************************************
+    ** Up to eight move sequences that each take two symbols in   **
+    ** a move stream, in any orientation of the cube. Writer and  **
+    ** reader need the same dictionary, the words are part of the **
+    ** stream format.                                             **
+    ***************************************************************/
+    uint8_t words[MAX_DICTIONARY_WORDS][MAX_WORD_LENGTH];
+    uint8_t lengths[MAX_DICTIONARY_WORDS];
+    unsigned nrWords;
+
+public:
+    MoveDictionary();
+
+    bool add(const int* moves, unsigned length);
+    unsigned match(const int* moves, size_t count, unsigned* length, unsigned* orientation) const;
+
+    unsigned getNrWords() const { return nrWords; }
+    const uint8_t* getWord(unsigned word) const { return words[word]; }
+    unsigned getLength(unsigned word) const { return lengths[word]; }
+};
+
+class MoveSequence {
+public:
+    /***************************************************************
+    ** One record of a move stream, read where it is: iterating   **
+    ** unpacks one symbol at a time and steps through dictionary  **
+    ** words, nothing is copied or allocated.                     **
+    ***************************************************************/
+    class Iterator {
+    private:
+        const MoveSequence* sequence;
+        size_t symbol;
+        unsigned position;      // move within the dictionary word of symbol
+
+    public:
+        Iterator(const MoveSequence* sequence, size_t symbol) : sequence(sequence), symbol(symbol), position(0) {}
+
+        int operator*() const;
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const { return symbol == other.symbol && position == other.position; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+private:
+    const uint8_t* packed;
+    size_t nrSymbols;
+    const MoveDictionary* dictionary;
+
+public:
+    MoveSequence() : packed(NULL), nrSymbols(0), dictionary(NULL) {}
+    MoveSequence(const uint8_t* packed, size_t nrSymbols, const MoveDictionary* dictionary)
+        : packed(packed), nrSymbols(nrSymbols), dictionary(dictionary) {}
+
+    unsigned getSymbol(size_t index) const {
+        size_t bit = index * MOVE_SYMBOL_BITS;
+        unsigned value = packed[bit / 8] >> bit % 8;
+        if (bit % 8 > 8 - MOVE_SYMBOL_BITS)
+            value |= packed[bit / 8 + 1] << (8 - bit % 8);
+        return value & (NR_MOVE_SYMBOLS - 1);
+    }
+    size_t getNrSymbols() const { return nrSymbols; }
+    size_t getNrMoves() const;
+    size_t getPackedSize() const { return (nrSymbols * MOVE_SYMBOL_BITS + 7) / 8; }
+    void decode(vector<int>* moves) const;
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, nrSymbols); }
+};
+
+class MoveStreamReader {
+private:
+    /***************************************************************
+    ** Goes through the records of a move stream in memory (a     **
+    ** mapped archive or a block read from a file). A record cut  **
+    ** off at the end of the data is left for the next block:     **
+    ** getOffset tells where it starts.                           **
+    ***************************************************************/
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    const MoveDictionary* dictionary;
+    bool damaged;
+
+public:
+    MoveStreamReader(const uint8_t* data, size_t size, const MoveDictionary* dictionary=NULL);
+
+    bool next(MoveSequence* sequence);
+    size_t getOffset() const { return offset; }
+    bool isDamaged() const { return damaged; }
+};
+
+class MoveStreamWriter {
+private:
+    /***************************************************************
+    ** Appends solutions to a file as packed records, collecting  **
+    ** MOVE_STREAM_BUFFER bytes before each write.                **
+    ***************************************************************/
+    FILE* file;
+    const MoveDictionary* dictionary;
+    vector<uint8_t> buffer;
+    uint64_t nrSolutions;
+    uint64_t nrMoves;
+    uint64_t nrBytes;
+    bool failed;
+
+    MoveStreamWriter(const MoveStreamWriter&);
+    MoveStreamWriter& operator=(const MoveStreamWriter&);
+
+public:
+    MoveStreamWriter(FILE* file, const MoveDictionary* dictionary=NULL);
+    ~MoveStreamWriter();
+
+    bool write(const int* moves, size_t count);
+    bool write(const vector<int>& moves) { return write(moves.data(), moves.size()); }
+    bool flush();
+
+    uint64_t getNrSolutions() const { return nrSolutions; }
+    uint64_t getNrMoves() const { return nrMoves; }
+    uint64_t getNrBytes() const { return nrBytes; }
+};
+
+size_t encodeMoves(const int* moves, size_t count, vector<uint8_t>* stream, const MoveDictionary* dictionary=NULL);
+size_t encodeMoves(const vector<int>& moves, vector<uint8_t>* stream, const MoveDictionary* dictionary=NULL);
+const MoveDictionary& getLayerByLayerDictionary();
+
+// the symbols of a record the reader handed out are valid, words and their orientations included
+inline int MoveSequence::Iterator::operator*() const {
+    unsigned value = sequence->getSymbol(symbol);
+    const uint8_t* word;
+
+    if (value < (unsigned) NR_MOVES)
+        return value;
+    word = sequence->dictionary->getWord(value - NR_MOVES);
+    return moveOrientationTable.moves[sequence->getSymbol(symbol + 1)][word[position]];
+}
+
+inline MoveSequence::Iterator& MoveSequence::Iterator::operator++() {
+    unsigned value = sequence->getSymbol(symbol);
+    if (value < (unsigned) NR_MOVES) {
+        symbol++;
+    } else if (++position == sequence->dictionary->getLength(value - NR_MOVES)) {
+        position = 0;
+        symbol += 2;
+    }
+    return *this;
+}
+
+#endif
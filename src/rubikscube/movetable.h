@@ -0,0 +1,83 @@
+// header file for the move code tables shared by the solver and the renderer
+
+#ifndef MOVETABLE_H
+#define MOVETABLE_H
+
+#include <stdint.h>
+
+using namespace std;
+
+/***************************************************************
+** Move codes as emitted into AlgoCube::moves                 **
+**  0 /  1 -- whole cube up / down along x                    **
+**  2 /  3 -- whole cube right / left along y                 **
+**  4 /  5 -- whole cube right / left along z                 **
+**  6- 8 /  9-11 -- layer 0-2 up / down along x               **
+** 12-14 / 15-17 -- layer 0-2 right / left along y            **
+** 18-20 / 21-23 -- layer 0-2 right / left along z            **
+** positions are x + 3*y + 9*z with                           **
+** [x: left->right] [y: front->back] [z: bottom->top]         **
+***************************************************************/
+
+const int NR_MOVES = 24;
+
+// 0: x, 1: y, 2: z
+constexpr unsigned moveAxis(int move) {
+    return move < 6 ? move / 2 : (move - 6) / 6;
+}
+
+// -1 for the whole cube spins
+constexpr int moveLayer(int move) {
+    return move < 6 ? -1 : (move - 6) % 3;
+}
+
+// down / left moves
+constexpr bool isReverseMove(int move) {
+    return move < 6 ? move % 2 == 1 : (move - 6) / 3 % 2 == 1;
+}
+
+constexpr int moveCode(unsigned axis, int layer, bool reverse) {
+    return layer < 0 ? 2*axis + reverse : 6 + 6*axis + 3*reverse + layer;
+}
+
+constexpr int inverseMove(int move) {
+    return moveCode(moveAxis(move), moveLayer(move), !isReverseMove(move));
+}
+
+constexpr bool isPositionInMove(unsigned position, int move) {
+    return moveLayer(move) < 0 || (moveAxis(move) == 0 ? position % 3 : moveAxis(move) == 1 ? position / 3 % 3 : position / 9) == (unsigned) moveLayer(move);
+}
+
+// position that the piece at position is turned to (see AlgoCube::spinLayer* for the 4-cycles)
+constexpr unsigned turnPosition(unsigned position, unsigned axis, bool reverse) {
+    unsigned c[3] = {position % 3, position / 3 % 3, position / 9};
+    unsigned p = (axis == 0) ? 1 : 0;
+    unsigned q = (axis == 2) ? 1 : 2;
+    unsigned cp = c[p];
+    unsigned cq = c[q];
+    c[p] = reverse ? 2 - cq : cq;
+    c[q] = reverse ? cp : 2 - cp;
+    return c[0] + 3*c[1] + 9*c[2];
+}
+
+struct PositionMoveTable {
+    // position the piece now at [move][position] came from
+    uint8_t from[NR_MOVES][27];
+};
+
+constexpr PositionMoveTable buildPositionMoveTable() {
+    PositionMoveTable table = {};
+    for (int move = 0; move < NR_MOVES; move++) {
+        for (unsigned position = 0; position < 27; position++) {
+            if (isPositionInMove(position, move))
+                table.from[move][position] = turnPosition(position, moveAxis(move), !isReverseMove(move));
+            else
+                table.from[move][position] = position;
+        }
+    }
+    return table;
+}
+
+constexpr PositionMoveTable positionMoveTable = buildPositionMoveTable();
+
+#endif
@@ -0,0 +1,197 @@
+/* standard includes */
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include "notation.h"
+
+using namespace std;
+
+// letters of the layers, index layer + 1 (0: whole cube) along each axis. Axis y of the move codes points from front to
+// back and z up, so Singmaster's y turns along z and z along y.
+static const char layerLetters[3][4] = {
+    {'x', 'L', 'M', 'R'},
+    {'z', 'F', 'S', 'B'},
+    {'y', 'D', 'E', 'U'}
+};
+
+// whether the clockwise turn of the letter is the reverse (down / left) move code
+static const bool clockwiseReverse[3][4] = {
+    {false, true, true, false},
+    {false, false, false, true},
+    {false, true, true, false}
+};
+
+// clockwise quarter turn of every letter: one move code, two for wide turns
+struct NotationMove {
+    uint8_t nrCodes;
+    int8_t codes[2];
+};
+
+struct NotationTable {
+    NotationMove letters[128];      // nrCodes 0 for no move
+    char names[NR_MOVES][3];        // text of each move code, zero terminated
+};
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+static NotationTable buildNotationTable() {
+    NotationTable table;
+    unsigned axis, index, letter;
+    int code;
+
+    memset(&table, 0, sizeof(table));
+    for (axis = 0; axis < 3; axis++) {
+        for (index = 0; index < 4; index++) {
+            letter = layerLetters[axis][index];
+            code = moveCode(axis, (int) index - 1, clockwiseReverse[axis][index]);
+            table.letters[letter].nrCodes = 1;
+            table.letters[letter].codes[0] = code;
+
+            table.names[code][0] = letter;
+            table.names[inverseMove(code)][0] = letter;
+            table.names[inverseMove(code)][1] = '\'';
+
+            // the outer layers (not M E S and not x y z) turn wide together with the middle layer
+            if (index == 1 || index == 3) {
+                letter = letter - 'A' + 'a';
+                table.letters[letter].nrCodes = 2;
+                table.letters[letter].codes[0] = code;
+                table.letters[letter].codes[1] = moveCode(axis, 1, clockwiseReverse[axis][index]);
+            }
+        }
+    }
+    return table;
+}
+
+static const NotationTable& notationTable() {
+    static const NotationTable table = buildNotationTable();
+    return table;
+}
+
+static bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+
+/**********************************************************************
+**                        FUNCTION DEFINITIONS                       **
+**********************************************************************/
+
+// the move codes of text (length chars, blanks between moves are optional) into moves, at most maxMoves of them, without
+// allocating anything. *nrMoves is the number of codes written; on an error *errorOffset is where the failing move
+// starts, after NOTATION_TOO_MANY_MOVES the rest of the text can be parsed from there into the next buffer.
+NotationResult parseNotation(const char* text, size_t length, int* moves, size_t maxMoves, size_t* nrMoves,
+                             size_t* errorOffset) {
+    const NotationTable& table = notationTable();
+    size_t position = 0, start, count = 0;
+    unsigned char letter;
+    unsigned power, i, j;
+    bool reverse;
+
+    for (;;) {
+        while (position < length && isBlank(text[position]))
+            position++;
+        if (position == length)
+            break;
+
+        start = position;
+        letter = text[position++];
+        if (letter >= 128 || table.letters[letter].nrCodes == 0) {
+            *nrMoves = count;
+            if (errorOffset != NULL)
+                *errorOffset = start;
+            return NOTATION_BAD_MOVE;
+        }
+        // Rw is r
+        if (letter >= 'A' && letter <= 'Z' && position < length && text[position] == 'w'
+            && table.letters[letter - 'A' + 'a'].nrCodes == 2) {
+            letter = letter - 'A' + 'a';
+            position++;
+        }
+        power = 1;
+        if (position < length && text[position] == '2') {
+            power = 2;
+            position++;
+        }
+        reverse = false;
+        if (position < length && text[position] == '\'') {
+            reverse = true;
+            position++;
+        } else if (position + 3 <= length && memcmp(text + position, "\xe2\x80\x99", 3) == 0) {
+            reverse = true;
+            position += 3;
+        }
+
+        const NotationMove& move = table.letters[letter];
+        if (count + power * move.nrCodes > maxMoves) {
+            *nrMoves = count;
+            if (errorOffset != NULL)
+                *errorOffset = start;
+            return NOTATION_TOO_MANY_MOVES;
+        }
+        for (i = 0; i < power; i++) {
+            for (j = 0; j < move.nrCodes; j++)
+                moves[count++] = reverse ? inverseMove(move.codes[j]) : move.codes[j];
+        }
+    }
+    *nrMoves = count;
+    return NOTATION_OK;
+}
+
+// appends the move codes of text to moves, false (and moves as before) if text is no move sequence
+bool parseNotation(const string& text, vector<int>* moves) {
+    size_t start = moves->size(), nrMoves;
+
+    // no move gives more than two codes per char (r2: 2 chars, 4 codes)
+    moves->resize(start + text.size() * 2);
+    if (parseNotation(text.data(), text.size(), moves->data() + start, text.size() * 2, &nrMoves) != NOTATION_OK) {
+        moves->resize(start);
+        return false;
+    }
+    moves->resize(start + nrMoves);
+    return true;
+}
+
+// the notation of the move codes, separated by blanks, with two equal codes in a row as a half turn (R2' for two R'). Writes only whole
+// moves and a terminating zero into text (size chars at most, MAX_NOTATION_CHARS per code always suffice) and returns
+// the length of the whole notation like snprintf, codes out of range show as '?'.
+size_t writeNotation(const int* moves, size_t nrMoves, char* text, size_t size) {
+    const NotationTable& table = notationTable();
+    size_t length = 0, written = 0, nameLength, i;
+    char name[4];               // blank, letter, 2, '
+
+    for (i = 0; i < nrMoves; i++) {
+        nameLength = 0;
+        if (length > 0)
+            name[nameLength++] = ' ';
+        if (moves[i] >= 0 && moves[i] < NR_MOVES) {
+            name[nameLength++] = table.names[moves[i]][0];
+            if (i + 1 < nrMoves && moves[i + 1] == moves[i]) {
+                name[nameLength++] = '2';
+                i++;
+            }
+            if (table.names[moves[i]][1] != 0)
+                name[nameLength++] = table.names[moves[i]][1];
+        } else {
+            name[nameLength++] = '?';
+        }
+        if (written == length && length + nameLength < size) {
+            memcpy(text + length, name, nameLength);
+            written += nameLength;
+        }
+        length += nameLength;
+    }
+    if (size > 0)
+        text[written] = 0;
+    return length;
+}
+
+string toNotation(const vector<int>& moves) {
+    vector<char> text(moves.size() * MAX_NOTATION_CHARS + 1);
+    size_t length = writeNotation(moves.data(), moves.size(), text.data(), text.size());
+    return string(text.data(), length);
+}
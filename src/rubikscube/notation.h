@@ -0,0 +1,41 @@
+// header file for notation.cc
+
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include <stddef.h>
+#include <vector>
+#include <string>
+#include "movetable.h"
+
+using namespace std;
+
+const size_t MAX_NOTATION_CHARS = 3;    // text of one move code at most, separator included ("R2 ")
+
+/***************************************************************
+** Singmaster notation, clockwise as seen from the face:      **
+**   R L U D F B     -- outer layers                          **
+**   M E S           -- middle layers, M turns like L, E like **
+**                      D, S like F                           **
+**   Rw r, Lw l, ... -- outer and middle layer together       **
+**   x y z           -- whole cube, like R, U and F           **
+** followed by ' (or U+2019) for counter-clockwise and 2 for  **
+** a half turn. A half turn is two quarter turn codes, R2'    **
+** two counter-clockwise ones (the same state, only animated  **
+** the other way), a wide turn one code per layer. Moves may  **
+** follow each other without blanks (RUR'U').                 **
+***************************************************************/
+
+enum NotationResult {
+    NOTATION_OK,
+    NOTATION_BAD_MOVE,          // no move of the notation at *errorOffset
+    NOTATION_TOO_MANY_MOVES     // the move at *errorOffset did not fit, the ones before are in moves
+};
+
+NotationResult parseNotation(const char* text, size_t length, int* moves, size_t maxMoves, size_t* nrMoves,
+                             size_t* errorOffset=NULL);
+bool parseNotation(const string& text, vector<int>* moves);
+size_t writeNotation(const int* moves, size_t nrMoves, char* text, size_t size);
+string toNotation(const vector<int>& moves);
+
+#endif
@@ -0,0 +1,146 @@
+/* standard includes */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "offscreen.h"
+#include <EGL/eglext.h>
+
+using namespace std;
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+// Mesa's display without any window system, the default display needs X or wayland on most drivers
+static EGLDisplay getHeadlessDisplay() {
+    const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay;
+    EGLDisplay display;
+
+    if (extensions != NULL && strstr(extensions, "EGL_MESA_platform_surfaceless") != NULL) {
+        getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay != NULL) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+            if (display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL))
+                return display;
+        }
+    }
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL))
+        return display;
+    return EGL_NO_DISPLAY;
+}
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+OffscreenContext::OffscreenContext() {
+    display = EGL_NO_DISPLAY;
+    context = EGL_NO_CONTEXT;
+    surface = EGL_NO_SURFACE;
+    framebuffer = 0;
+    renderbuffers[0] = 0;
+    renderbuffers[1] = 0;
+    width = 0;
+    height = 0;
+}
+
+OffscreenContext::~OffscreenContext() {
+    destroy();
+}
+
+// the context is current afterwards, the GL functions can be loaded (glewInit) before createFramebuffer
+bool OffscreenContext::create(unsigned width, unsigned height) {
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    const EGLint surfaceAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+    const char* extensions;
+    EGLConfig config;
+    EGLint nrConfigs;
+
+    destroy();
+    this->width = width;
+    this->height = height;
+
+    display = getHeadlessDisplay();
+    if (display == EGL_NO_DISPLAY) {
+        fprintf(stderr, "Error: no EGL display\n");
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(display, configAttributes, &config, 1, &nrConfigs) || nrConfigs < 1) {
+        fprintf(stderr, "Error: no EGL config for OpenGL\n");
+        destroy();
+        return false;
+    }
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT) {
+        fprintf(stderr, "Error: cannot create an OpenGL 3.3 context (EGL error 0x%x)\n", eglGetError());
+        destroy();
+        return false;
+    }
+    // the frames go to the framebuffer object, a surface is only needed where a context cannot go without
+    extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (extensions == NULL || strstr(extensions, "EGL_KHR_surfaceless_context") == NULL)
+        surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+    if (!eglMakeCurrent(display, surface, surface, context)) {
+        fprintf(stderr, "Error: cannot make the EGL context current (EGL error 0x%x)\n", eglGetError());
+        destroy();
+        return false;
+    }
+    return true;
+}
+
+bool OffscreenContext::createFramebuffer() {
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(2, renderbuffers);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "Error: offscreen framebuffer incomplete\n");
+        return false;
+    }
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+void OffscreenContext::destroy() {
+    if (display == EGL_NO_DISPLAY)
+        return;
+    if (context != EGL_NO_CONTEXT && framebuffer != 0) {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(2, renderbuffers);
+    }
+    framebuffer = 0;
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context != EGL_NO_CONTEXT)
+        eglDestroyContext(display, context);
+    if (surface != EGL_NO_SURFACE)
+        eglDestroySurface(display, surface);
+    eglTerminate(display);
+    display = EGL_NO_DISPLAY;
+    context = EGL_NO_CONTEXT;
+    surface = EGL_NO_SURFACE;
+}
@@ -0,0 +1,45 @@
+// header file for offscreen.cc
+
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+#include <stdint.h>
+#include <vector>
+
+/* We use glew.h instead of gl.h to get all the GL prototypes declared */
+#include <GL/glew.h>
+#include <EGL/egl.h>
+
+using namespace std;
+
+class OffscreenContext {
+private:
+    /***************************************************************
+    ** OpenGL 3.3 core context without a window or display       **
+    ** server: EGL on Mesa's surfaceless platform (llvmpipe when  **
+    ** there is no GPU), else on the default display. Everything  **
+    ** is drawn into a framebuffer object with color and depth    **
+    ** renderbuffers of the frame size and read back from there.  **
+    ***************************************************************/
+    EGLDisplay display;
+    EGLContext context;
+    EGLSurface surface;         // EGL_NO_SURFACE where surfaceless contexts work
+    GLuint framebuffer;
+    GLuint renderbuffers[2];    // color, depth
+    unsigned width;
+    unsigned height;
+
+    OffscreenContext(const OffscreenContext&);
+    OffscreenContext& operator=(const OffscreenContext&);
+
+public:
+    OffscreenContext();
+    ~OffscreenContext();
+
+    bool create(unsigned width, unsigned height);
+    bool createFramebuffer();
+    GLuint getFramebuffer() const { return framebuffer; }
+    void destroy();
+};
+
+#endif
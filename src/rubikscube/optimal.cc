@@ -0,0 +1,221 @@
+/* standard includes */
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "optimal.h"
+#include "cubecoords.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                             CONSTANTS                             **
+**********************************************************************/
+
+const unsigned MAX_OPTIMAL_LENGTH = 26;
+
+
+/**********************************************************************
+**                               SEARCH                              **
+**********************************************************************/
+
+struct OptimalSearch {
+    const OptimalSolver& solver;
+    uint8_t path[MAX_OPTIMAL_LENGTH];
+    unsigned long long nodes;
+    unsigned long long expanded;
+    chrono::steady_clock::time_point deadline;
+    bool limited;
+    bool stopped;
+
+    OptimalSearch(const OptimalSolver& solver, unsigned timeLimitMs)
+        : solver(solver), nodes(0), expanded(0), deadline(chrono::steady_clock::now() + chrono::milliseconds(timeLimitMs)),
+          limited(timeLimitMs > 0), stopped(false) {}
+
+    unsigned distance(size_t cornerIndex, size_t edgeIndex0, size_t edgeIndex1) {
+        unsigned h = solver.cornerTable.get(cornerIndex);
+        unsigned e = solver.edgeTables[0].get(edgeIndex0);
+        if (e > h)
+            h = e;
+        e = solver.edgeTables[1].get(edgeIndex1);
+        return e > h ? e : h;
+    }
+
+    // all children are generated and their table entries prefetched before the first one is looked at, the tables
+    // are far too large for the cache and the lookups would otherwise wait on memory one after the other
+    bool search(unsigned cornerPerm, unsigned twist, const uint8_t* slots, unsigned distanceLeft, unsigned depth, unsigned togo, unsigned lastFace) {
+        unsigned nextCornerPerm[NR_FACE_MOVES], nextTwist[NR_FACE_MOVES];
+        uint8_t nextSlots[NR_FACE_MOVES][12];
+        size_t cornerIndex[NR_FACE_MOVES], edgeIndex[NR_FACE_MOVES][2];
+        unsigned face, m, i;
+
+        if (togo == 0)
+            return distanceLeft == 0;
+        if (limited && ++expanded % 4096 == 0 && chrono::steady_clock::now() > deadline)
+            stopped = true;
+        if (stopped)
+            return false;
+
+        for (face = 0; face < 6; face++) {
+            if (isRedundantFace(face, lastFace))
+                continue;
+            for (m = 3*face; m < 3*face + 3; m++) {
+                nextCornerPerm[m] = solver.cornerPermMove[cornerPerm*NR_FACE_MOVES + m];
+                nextTwist[m] = solver.twistMove[twist*NR_FACE_MOVES + m];
+                cornerIndex[m] = (size_t) nextCornerPerm[m] * NR_TWISTS + nextTwist[m];
+                __builtin_prefetch(solver.cornerTable.getData() + cornerIndex[m] / 2);
+                for (i = 0; i < 12; i++)
+                    nextSlots[m][i] = solver.edgeSlotMove[slots[i]][m];
+                edgeIndex[m][0] = edgeSubsetRank(nextSlots[m]);
+                edgeIndex[m][1] = edgeSubsetRank(nextSlots[m] + 6);
+                __builtin_prefetch(solver.edgeTables[0].getData() + edgeIndex[m][0] / 2);
+                __builtin_prefetch(solver.edgeTables[1].getData() + edgeIndex[m][1] / 2);
+                nodes++;
+            }
+        }
+
+        for (face = 0; face < 6; face++) {
+            if (isRedundantFace(face, lastFace))
+                continue;
+            for (m = 3*face; m < 3*face + 3; m++) {
+                unsigned h = distance(cornerIndex[m], edgeIndex[m][0], edgeIndex[m][1]);
+                if (h >= togo)
+                    continue;
+                path[depth] = m;
+                if (search(nextCornerPerm[m], nextTwist[m], nextSlots[m], h, depth + 1, togo - 1, face))
+                    return true;
+            }
+        }
+        return false;
+    }
+};
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+// maps the pattern databases from the pattern files in directory, builds those that are missing (all for "") with
+// nrThreads threads (0: one per cpu)
+OptimalSolver::OptimalSolver(const string& directory, unsigned nrThreads) {
+    const unsigned edgeKinds[2] = {EDGE_PATTERNS_0, EDGE_PATTERNS_1};
+    uint8_t home[12];
+    unsigned c, slot;
+
+    buildMoveTables();
+
+    if (directory.empty() || !cornerTable.load(getPatternPath(directory, CORNER_PATTERNS), CORNER_PATTERNS, NR_CORNER_PATTERNS, 4)) {
+        cornerTable.allocate(CORNER_PATTERNS, NR_CORNER_PATTERNS, 4);
+        cornerTable.build(0, NR_FACE_MOVES, [this](uint64_t index, uint64_t* next) {
+            unsigned cornerPerm = index / NR_TWISTS, twist = index % NR_TWISTS, m;
+            for (m = 0; m < NR_FACE_MOVES; m++)
+                next[m] = (uint64_t) cornerPermMove[cornerPerm*NR_FACE_MOVES + m] * NR_TWISTS + twistMove[twist*NR_FACE_MOVES + m];
+        }, nrThreads);
+    }
+
+    for (slot = 0; slot < 12; slot++)
+        home[slot] = slot;
+    for (c = 0; c < 2; c++) {
+        if (!directory.empty() && edgeTables[c].load(getPatternPath(directory, edgeKinds[c]), edgeKinds[c], NR_EDGE_SUBSETS, 4))
+            continue;
+        edgeTables[c].allocate(edgeKinds[c], NR_EDGE_SUBSETS, 4);
+        edgeTables[c].build(edgeSubsetRank(home + 6*c), NR_FACE_MOVES, [this](uint64_t index, uint64_t* next) {
+            uint8_t slots[6], moved[6];
+            unsigned m, i;
+            edgeSubsetUnrank(index, slots);
+            for (m = 0; m < NR_FACE_MOVES; m++) {
+                for (i = 0; i < 6; i++)
+                    moved[i] = edgeSlotMove[slots[i]][m];
+                next[m] = edgeSubsetRank(moved);
+            }
+        }, nrThreads);
+    }
+}
+
+void OptimalSolver::buildMoveTables() {
+    unsigned c, m, slot, flip;
+
+    cornerPermMove.resize(NR_PERMS * NR_FACE_MOVES);
+    for (c = 0; c < NR_PERMS; c++) {
+        for (m = 0; m < NR_FACE_MOVES; m++) {
+            CubeState state;
+            setCornerPerm(&state, c);
+            applyFaceMove(&state, m);
+            cornerPermMove[c*NR_FACE_MOVES + m] = getCornerPerm(state);
+        }
+    }
+    twistMove.resize(NR_TWISTS * NR_FACE_MOVES);
+    for (c = 0; c < NR_TWISTS; c++) {
+        for (m = 0; m < NR_FACE_MOVES; m++) {
+            CubeState state;
+            setTwist(&state, c);
+            applyFaceMove(&state, m);
+            twistMove[c*NR_FACE_MOVES + m] = getTwist(state);
+        }
+    }
+    // the cubie now in a slot came from the slot of its number in the solved cube
+    memset(edgeSlotMove, 0, sizeof(edgeSlotMove));
+    for (m = 0; m < NR_FACE_MOVES; m++) {
+        CubeState state;
+        applyFaceMove(&state, m);
+        for (slot = 0; slot < 12; slot++)
+            for (flip = 0; flip < 2; flip++)
+                edgeSlotMove[state.edgePerm(slot) | flip << 4][m] = slot | (flip ^ state.edgeFlip(slot)) << 4;
+    }
+}
+
+bool OptimalSolver::saveTables(const string& directory) const {
+    return cornerTable.save(getPatternPath(directory, CORNER_PATTERNS)) && edgeTables[0].save(getPatternPath(directory, EDGE_PATTERNS_0))
+        && edgeTables[1].save(getPatternPath(directory, EDGE_PATTERNS_1));
+}
+
+// solver shared by all callers, the tables are mapped (or built) on first use
+const OptimalSolver& OptimalSolver::getInstance() {
+    static const OptimalSolver solver(getPatternDirectory());
+    return solver;
+}
+
+// appends a shortest solution in face turns to moves (whole cube spins first if the centers are turned). Returns false
+// if state cannot be solved, needs more than maxLength face turns or the time limit (0: none) is over.
+bool OptimalSolver::solve(const CubeState& state, vector<int>* moves, OptimalStats* stats, unsigned maxLength, unsigned timeLimitMs) const {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    CubeState oriented = state;
+    OptimalSearch search(*this, timeLimitMs);
+    vector<int> spins;
+    uint8_t slots[12];
+    unsigned cornerPerm, twist, h, depth, completed, i;
+    bool found = false;
+
+    if (maxLength >= MAX_OPTIMAL_LENGTH)
+        maxLength = MAX_OPTIMAL_LENGTH - 1;
+    if (!normalizeOrientation(&oriented, &spins) || !isSolvable(oriented))
+        return false;
+
+    cornerPerm = getCornerPerm(oriented);
+    twist = getTwist(oriented);
+    getEdgeSlots(oriented, slots);
+    h = search.distance((size_t) cornerPerm * NR_TWISTS + twist, edgeSubsetRank(slots), edgeSubsetRank(slots + 6));
+
+    // the heuristic never overestimates, so every depth below it counts as searched
+    completed = h > 0 ? h - 1 : 0;
+    for (depth = h; depth <= maxLength; depth++) {
+        found = search.search(cornerPerm, twist, slots, h, 0, depth, NO_FACE);
+        if (found || search.stopped)
+            break;
+        completed = depth;
+    }
+
+    if (stats != NULL) {
+        stats->depth = found ? depth : completed;
+        stats->nodes = search.nodes;
+        stats->seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    if (!found)
+        return false;
+
+    moves->insert(moves->end(), spins.begin(), spins.end());
+    for (i = 0; i < depth; i++)
+        appendFaceMove(search.path[i], moves);
+    return true;
+}
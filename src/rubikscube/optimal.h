@@ -0,0 +1,58 @@
+// header file for optimal.cc
+
+#ifndef OPTIMAL_H
+#define OPTIMAL_H
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include "cubestate.h"
+#include "cubecoords.h"
+#include "patterndb.h"
+
+using namespace std;
+
+const unsigned NR_CORNER_PATTERNS = NR_PERMS * NR_TWISTS;
+
+struct OptimalStats {
+    unsigned depth;             // solution length, or the last depth searched completely
+    unsigned long long nodes;   // positions generated
+    double seconds;
+
+    double getNodesPerSecond() const { return seconds > 0 ? nodes / seconds : 0; }
+};
+
+class OptimalSolver {
+private:
+    /***************************************************************
+    ** IDA* in the face turn metric, the heuristic is the maximum **
+    ** of three pattern databases holding the exact distance to   **
+    ** solved of a part of the cube (4 bits per entry):           **
+    ** CORNERS -- all corners, 8! * 3^7 entries                   **
+    ** EDGES   -- edges 0-5 and edges 6-11, 12!/6! * 2^6 entries  **
+    **            each (see edgeSubsetRank in cubecoords.h)       **
+    ** The constructor maps them from pattern files (see pdbgen)  **
+    ** or builds the missing ones, which takes about a minute     **
+    ** and 90MB on a single core.                                 **
+    ***************************************************************/
+    vector<uint16_t> cornerPermMove;    // [40320][NR_FACE_MOVES]
+    vector<uint16_t> twistMove;         // [2187][NR_FACE_MOVES]
+    uint8_t edgeSlotMove[32][NR_FACE_MOVES];    // slot | flip << 4 of one edge after the move
+
+    PatternTable cornerTable;
+    PatternTable edgeTables[2];
+
+    void buildMoveTables();
+
+    friend struct OptimalSearch;
+
+public:
+    OptimalSolver(const string& directory="", unsigned nrThreads=0);
+    bool saveTables(const string& directory) const;
+
+    bool solve(const CubeState& state, vector<int>* moves, OptimalStats* stats=NULL, unsigned maxLength=20, unsigned timeLimitMs=0) const;
+
+    static const OptimalSolver& getInstance();
+};
+
+#endif
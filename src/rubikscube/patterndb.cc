@@ -0,0 +1,200 @@
+/* standard includes */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "patterndb.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+static const char patternMagic[8] = {'R', 'C', 'P', 'A', 'T', 'D', 'B', '\0'};
+
+static const char* patternFileName(unsigned kind) {
+    switch (kind) {
+        case CORNER_PATTERNS: return "corners.pdb";
+        case EDGE_PATTERNS_0: return "edges0.pdb";
+        case EDGE_PATTERNS_1: return "edges1.pdb";
+        case PHASE1_SLICE_TWIST: return "slicetwist.pdb";
+        case PHASE1_SLICE_FLIP: return "sliceflip.pdb";
+        case PHASE2_CORNER_PERM: return "cornerperm.pdb";
+        case PHASE2_EDGE_PERM: return "edgeperm.pdb";
+    }
+    return "unknown.pdb";
+}
+
+// FNV-1a, 64 bit. Data written in parts goes on from the hash of the parts before.
+uint64_t patternChecksum(const uint8_t* data, size_t size, uint64_t hash) {
+    size_t i;
+    for (i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// RUBIKSCUBE_PDB_DIR if set, else pdb in the working directory (like img for the textures)
+string getPatternDirectory() {
+    const char* directory = getenv("RUBIKSCUBE_PDB_DIR");
+    return directory != NULL && directory[0] != '\0' ? directory : "pdb";
+}
+
+string getPatternPath(const string& directory, unsigned kind) {
+    return directory + "/" + patternFileName(kind);
+}
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+PatternTable::PatternTable() {
+    data = NULL;
+    mapping = NULL;
+    mappingSize = 0;
+    entries = 0;
+    bits = 8;
+    kind = 0;
+}
+
+PatternTable::~PatternTable() {
+    release();
+}
+
+// in memory table with every entry unknown
+void PatternTable::allocate(unsigned kind, uint64_t entries, unsigned bits) {
+    release();
+    this->kind = kind;
+    this->entries = entries;
+    this->bits = bits;
+    owned.assign(getDataSize(), 0xff);
+    data = owned.data();
+}
+
+void PatternTable::release() {
+    if (mapping != NULL)
+        munmap(mapping, mappingSize);
+    mapping = NULL;
+    mappingSize = 0;
+    vector<uint8_t>().swap(owned);
+    data = NULL;
+    entries = 0;
+}
+
+// maps the pattern file read-only, returns false if it is missing or does not hold the expected table. The checksum is
+// not checked here as that would page in the whole file, see verify.
+bool PatternTable::load(const string& path, unsigned kind, uint64_t entries, unsigned bits) {
+    PatternFileHeader header;
+    struct stat status;
+    void* mapped;
+    int fd;
+
+    release();
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    if (fstat(fd, &status) != 0 || read(fd, &header, sizeof(header)) != (ssize_t) sizeof(header)) {
+        close(fd);
+        return false;
+    }
+
+    this->kind = kind;
+    this->entries = entries;
+    this->bits = bits;
+    if (memcmp(header.magic, patternMagic, sizeof(patternMagic)) != 0 || header.version != PATTERN_FILE_VERSION
+        || header.kind != kind || header.entries != entries || header.bits != bits || header.dataSize != getDataSize()
+        || (uint64_t) status.st_size < PATTERN_DATA_OFFSET + header.dataSize) {
+        fprintf(stderr, "%s: no valid pattern file of version %u, regenerate it with pdbgen\n", path.c_str(), PATTERN_FILE_VERSION);
+        close(fd);
+        this->entries = 0;
+        return false;
+    }
+
+    mapped = mmap(NULL, PATTERN_DATA_OFFSET + header.dataSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        this->entries = 0;
+        return false;
+    }
+    // lookups jump around the whole table, reading ahead would only page in entries that are never used
+    madvise(mapped, PATTERN_DATA_OFFSET + header.dataSize, MADV_RANDOM);
+
+    mapping = mapped;
+    mappingSize = PATTERN_DATA_OFFSET + header.dataSize;
+    data = (uint8_t*) mapped + PATTERN_DATA_OFFSET;
+    return true;
+}
+
+// writes a temporary file first and renames it, processes mapping the old file keep their copy
+bool PatternTable::save(const string& path) const {
+    PatternFileHeader header;
+    char padding[PATTERN_DATA_OFFSET - sizeof(PatternFileHeader)];
+    string temporary = path + ".tmp";
+    FILE* file;
+    bool ok;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, patternMagic, sizeof(patternMagic));
+    header.version = PATTERN_FILE_VERSION;
+    header.kind = kind;
+    header.entries = entries;
+    header.bits = bits;
+    header.dataSize = getDataSize();
+    header.checksum = patternChecksum(data, getDataSize());
+    memset(padding, 0, sizeof(padding));
+
+    file = fopen(temporary.c_str(), "wb");
+    if (file == NULL)
+        return false;
+    ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(padding, sizeof(padding), 1, file) == 1
+        && fwrite(data, 1, getDataSize(), file) == getDataSize();
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// recomputes the checksum of a mapped table, tables built in memory are always valid
+bool PatternTable::verify() const {
+    const PatternFileHeader* header = (const PatternFileHeader*) mapping;
+    if (mapping == NULL)
+        return data != NULL;
+    return header->checksum == patternChecksum(data, getDataSize());
+}
+
+unsigned PatternTable::getAtomic(uint64_t index) const {
+    uint8_t byte = __atomic_load_n(&data[bits == 4 ? index / 2 : index], __ATOMIC_RELAXED);
+    return bits == 4 ? byte >> (index % 2 * 4) & 15 : byte;
+}
+
+// returns true if the entry was unknown and is set now
+bool PatternTable::setIfUnknown(uint64_t index, unsigned distance) {
+    uint8_t* byte = &data[bits == 4 ? index / 2 : index];
+    uint8_t expected = __atomic_load_n(byte, __ATOMIC_RELAXED);
+    uint8_t desired;
+    unsigned shift = index % 2 * 4;
+
+    if (bits != 4) {
+        expected = UNKNOWN_DISTANCE_8;
+        return __atomic_compare_exchange_n(byte, &expected, (uint8_t) distance, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
+    // the other nibble of the byte may change at the same time
+    do {
+        if ((expected >> shift & 15) != UNKNOWN_DISTANCE_4)
+            return false;
+        desired = (expected & ~(15 << shift)) | distance << shift;
+    } while (!__atomic_compare_exchange_n(byte, &expected, desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    return true;
+}
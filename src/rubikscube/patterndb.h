@@ -0,0 +1,142 @@
+// header file for patterndb.cc
+
+#ifndef PATTERNDB_H
+#define PATTERNDB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+
+using namespace std;
+
+const uint32_t PATTERN_FILE_VERSION = 1;
+const unsigned PATTERN_DATA_OFFSET = 4096;  // data starts page aligned behind the header
+const unsigned UNKNOWN_DISTANCE_4 = 15;
+const unsigned UNKNOWN_DISTANCE_8 = 255;
+const uint64_t CHECKSUM_START = 14695981039346656037ull;   // FNV-1a offset basis
+
+// the tables stored on disk, the numbers are part of the file format
+enum PatternKind {
+    CORNER_PATTERNS = 1,
+    EDGE_PATTERNS_0 = 2,        // edges 0-5
+    EDGE_PATTERNS_1 = 3,        // edges 6-11
+    PHASE1_SLICE_TWIST = 4,
+    PHASE1_SLICE_FLIP = 5,
+    PHASE2_CORNER_PERM = 6,
+    PHASE2_EDGE_PERM = 7
+};
+
+struct PatternFileHeader {
+    /***************************************************************
+    ** Header of a pattern file, all fields little endian.        **
+    ** The data (entries * bits / 8 bytes, rounded up) follows at **
+    ** PATTERN_DATA_OFFSET, 4 bit entries hold the even index in  **
+    ** the low nibble. The checksum is FNV-1a (64 bit) over the   **
+    ** data bytes.                                                **
+    ***************************************************************/
+    char magic[8];              // "RCPATDB" and a zero byte
+    uint32_t version;           // PATTERN_FILE_VERSION
+    uint32_t kind;              // PatternKind
+    uint64_t entries;
+    uint32_t bits;              // 4 or 8 bits per entry
+    uint32_t reserved;
+    uint64_t dataSize;
+    uint64_t checksum;
+};
+
+class PatternTable {
+private:
+    /***************************************************************
+    ** Table of distances to solved, either built in memory or    **
+    ** mapped read-only from a pattern file. A mapped table only  **
+    ** pages in what is looked up and is shared with every other  **
+    ** process mapping the same file.                             **
+    ***************************************************************/
+    vector<uint8_t> owned;
+    uint8_t* data;
+    void* mapping;
+    size_t mappingSize;
+    uint64_t entries;
+    unsigned bits;
+    unsigned kind;
+
+    PatternTable(const PatternTable&);
+    PatternTable& operator=(const PatternTable&);
+
+public:
+    PatternTable();
+    ~PatternTable();
+
+    void allocate(unsigned kind, uint64_t entries, unsigned bits);
+    void release();
+    bool load(const string& path, unsigned kind, uint64_t entries, unsigned bits);
+    bool save(const string& path) const;
+    bool verify() const;
+    bool isMapped() const { return mapping != NULL; }
+
+    unsigned get(uint64_t index) const {
+        return bits == 4 ? data[index / 2] >> (index % 2 * 4) & 15 : data[index];
+    }
+    const uint8_t* getData() const { return data; }
+    uint64_t getEntries() const { return entries; }
+    size_t getDataSize() const { return bits == 4 ? (entries + 1) / 2 : entries; }
+
+    // only for the breadth first search filling the table, several threads may set entries at once
+    unsigned getAtomic(uint64_t index) const;
+    bool setIfUnknown(uint64_t index, unsigned distance);
+
+    template <class Neighbors>
+    void build(uint64_t start, unsigned nrMoves, Neighbors neighbors, unsigned nrThreads=0);
+};
+
+uint64_t patternChecksum(const uint8_t* data, size_t size, uint64_t hash=CHECKSUM_START);
+string getPatternDirectory();
+string getPatternPath(const string& directory, unsigned kind);
+
+
+/**********************************************************************
+**                      TEMPLATE MEMBER DEFINITIONS                  **
+**********************************************************************/
+
+// breadth first search from start over an allocated table, neighbors(index, next) fills next with the nrMoves indices
+// reached in one move. Every depth is split into equal index ranges, one per thread (0: one per cpu).
+template <class Neighbors>
+void PatternTable::build(uint64_t start, unsigned nrMoves, Neighbors neighbors, unsigned nrThreads) {
+    unsigned unknown = bits == 4 ? UNKNOWN_DISTANCE_4 : UNKNOWN_DISTANCE_8;
+    unsigned depth, t;
+    atomic<bool> changed(true);
+
+    if (nrThreads == 0)
+        nrThreads = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+    setIfUnknown(start, 0);
+
+    for (depth = 0; changed && depth + 1 < unknown; depth++) {
+        vector<thread> threads;
+        changed = false;
+        for (t = 0; t < nrThreads; t++) {
+            threads.push_back(thread([this, t, nrThreads, nrMoves, depth, &changed, &neighbors]() {
+                uint64_t first = entries * t / nrThreads, last = entries * (t + 1) / nrThreads;
+                uint64_t index, next[32];
+                unsigned m;
+                bool found = false;
+
+                for (index = first; index < last; index++) {
+                    if (getAtomic(index) != depth)
+                        continue;
+                    neighbors(index, next);
+                    for (m = 0; m < nrMoves; m++)
+                        found |= setIfUnknown(next[m], depth + 1);
+                }
+                if (found)
+                    changed = true;
+            }));
+        }
+        for (t = 0; t < nrThreads; t++)
+            threads[t].join();
+    }
+}
+
+#endif
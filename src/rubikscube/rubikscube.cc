@@ -4,7 +4,15 @@
 #include<vector>
 #include<string>
 #include <array>
+#include <stdexcept>
 #include "rubikscube.h"
+#include "movetable.h"
+#include "twophase.h"
+#include "optimal.h"
+#include "moveoptimizer.h"
+#include "cubecoords.h"
+#include "facecube.h"
+#include "scrambler.h"
 
 /* We use glew.h instead of gl.h to get all the GL prototypes declared */
 //#include<GL/glew.h>
@@ -36,33 +44,42 @@ void Color::setColor(char color) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-CubePiece::CubePiece(){}
+CubePiece::CubePiece() {
+    nrColors = 0;
+}
 
 CubePiece::CubePiece(string colorstring) {
+    setColors(colorstring);
+}
+
+CubePiece::CubePiece(const char* colors, unsigned nrColors) {
     unsigned i;
-    for (i = 0; i < colorstring.size(); i++) {
-        colors.push_back(Color(colorstring.at(i)));
+    for (i = 0; i < nrColors && i < 3; i++) {
+        this->colors[i] = Color(colors[i]);
     }
+    this->nrColors = i;
 }
 
 void CubePiece::setColors(string colorstring) {
-    colors.clear();
     unsigned i;
-    for (i = 0; i < colorstring.size(); i++) {
-        colors.push_back(Color(colorstring.at(i)));
+    for (i = 0; i < colorstring.size() && i < 3; i++) {
+        colors[i] = Color(colorstring.at(i));
     }
+    nrColors = i;
 }
 
 char CubePiece::getColor(unsigned index) {
-    return colors.at(index).getColorChar();
+    if (index >= nrColors)
+        throw out_of_range("CubePiece::getColor");
+    return colors[index].getColorChar();
 }
 
 string CubePiece::getColors() {
     unsigned i;
     string ret = "";
 
-    for (i = 0; i < colors.size(); i++) {
-        ret = ret + colors.at(i).getColorChar();
+    for (i = 0; i < nrColors; i++) {
+        ret = ret + colors[i].getColorChar();
     }
 
     return ret;
@@ -71,8 +88,8 @@ string CubePiece::getColors() {
 void CubePiece::print() {
     string out = "";
     unsigned i;
-    for (i = 0; i < colors.size(); i++) {
-        if (i == colors.size() -1) {
+    for (i = 0; i < nrColors; i++) {
+        if (i == nrColors -1) {
             cout << out << colors[i].getColorChar() << "\n";
             return;
         }
@@ -81,89 +98,21 @@ void CubePiece::print() {
 }
 
 bool CubePiece::isCornerPiece() {
-    if (colors.size() == 3)
+    if (nrColors == 3)
         return true;
     else return false;
 }
 bool CubePiece::isEdgePiece() {
-    if (colors.size() == 2)
+    if (nrColors == 2)
         return true;
     else return false;
 }
 bool CubePiece::isSurfacePiece() {
-    if (colors.size() == 1 && getColor(0) != '-')
+    if (nrColors == 1 && getColor(0) != '-')
         return true;
     else return false;
 }
 
-// prepareCornerPieceMove functions
-
-/************************************************************************************************
-** functions that turn the color order of the CubePiece so it is oriented correctly            **
-** after the particular move                                                                   **
-************************************************************************************************/
-void CubePiece::prepareCornerPieceMove90AlongX() {
-    string prepared = "";
-    char initCol1 = getColor(0);
-    char initCol2 = getColor(1);
-    char initCol3 = getColor(2);
-    prepared = prepared + initCol2 + initCol1 + initCol3;
-    setColors(prepared);
-}
-
-void CubePiece::prepareEdgePieceMove90AlongX(unsigned z, unsigned x) {
-    string prepared = "";
-    char initCol1 = getColor(0);
-    char initCol2 = getColor(1);
-
-    // orientation only changes in the particular case
-    if (z == 0 || z == 2) {  // top and bottom layer behave differently than middle one
-        if (x == 1) {
-            prepared = prepared + initCol2 + initCol1;
-            setColors(prepared);
-        }
-    }
-}
-
-void CubePiece::prepareCornerPieceMove90AlongY() {
-    string prepared = "";
-    char initCol1 = getColor(0);
-    char initCol2 = getColor(1);
-    char initCol3 = getColor(2);
-    prepared = prepared + initCol1 + initCol3 + initCol2;
-    setColors(prepared);
-}
-
-void CubePiece::prepareEdgePieceMove90AlongY(unsigned y) {
-    string prepared = "";
-    char initCol1 = getColor(0);
-    char initCol2 = getColor(1);
-
-    // orientation only changes in the second y layer
-    if (y == 1) {
-        prepared = prepared + initCol2 + initCol1;
-        setColors(prepared);
-    }
-}
-
-// changes the color orientation of the cubepiece so it ist correctly oriented after the move
-void CubePiece::prepareCornerPieceMove90AlongZ() {
-    string prepared = "";
-    char initCol1 = getColor(0);
-    char initCol2 = getColor(1);
-    char initCol3 = getColor(2);
-    prepared = prepared + initCol3 + initCol2 + initCol1;
-    setColors(prepared);
-}
-
-void CubePiece::prepareEdgePieceMove90AlongZ() {
-    string prepared = "";
-    char initCol1 = getColor(0);
-    char initCol2 = getColor(1);
-    prepared = prepared + initCol2 + initCol1;
-    setColors(prepared);
-}
-
 // returns true if the corresponding color is on top (or bottom) of the cube (on one of the edge pieces)
 bool CubePiece::isColorOnTopOfEdgePiece(char color, unsigned x) {
     if (x == 0 || x == 2) {
@@ -221,28 +170,38 @@ int CubePiece::getPositionOfColor(char color) {
 ///////////////////////////////////////////////////////////////////////////////
 
 
-AlgoCube::AlgoCube() {}
+AlgoCube::AlgoCube() {
+    verbose = true;
+}
 
 AlgoCube::AlgoCube(vector<CubePiece> pieces) {
-    unsigned i, x, y, z;
-    i = 0;
+    verbose = true;
+    setPieces(pieces);
+}
 
-    for (z = 0; z < 3; z++) {
-        for (y = 0; y < 3; y++) {
-            for (x = 0; x < 3; x++) {
-                if (i < 27) {
-                    cubePieces[x][y][z] = pieces[i];
-                    i++;
-                }
-            }
-        }
-    }
+// the pieces are not stored, they are read from the compact state when needed
+CubePiece AlgoCube::piece(unsigned x, unsigned y, unsigned z) {
+    char colors[3];
+    unsigned nrColors = state.getColors(x, y, z, colors);
+    return CubePiece(colors, nrColors);
+}
+
+CubeState AlgoCube::getState() {
+    return state;
+}
+
+void AlgoCube::setState(CubeState state) {
+    this->state = state;
 }
 
 vector<int> AlgoCube::getMoves() {
     return moves;
 }
 
+void AlgoCube::setVerbose(bool verbose) {
+    this->verbose = verbose;
+}
+
 vector<int> AlgoCube::getRandomizeCubeMoves() {
     return randomizeCubeMoves;
 }
@@ -254,8 +213,12 @@ void AlgoCube::setPieces(vector<CubePiece> pieces) {
     for (z = 0; z < 3; z++) {
         for (y = 0; y < 3; y++) {
             for (x = 0; x < 3; x++) {
-                if (i < 27) {
-                    cubePieces[x][y][z] = pieces[i];
+                if (i < pieces.size()) {
+                    string colors = pieces[i].getColors();
+                    if (!state.setColors(x, y, z, colors.c_str(), colors.size())) {
+                        cout << "piece " << colors << " does not fit at " << x << y << z << endl;
+                        exit(1);
+                    }
                     i++;
                 }
             }
@@ -270,7 +233,7 @@ void AlgoCube::printFirstLayer() {
 
     for (i = 0; i < 3; i++) {
         for (p = 0; p < 3; p++) {
-            cubePieces[p][i][0].print();
+            piece(p, i, 0).print();
             cout << "\n";
         }
     }
@@ -289,7 +252,7 @@ void AlgoCube::printWholeCube() {
             cout << "Third layer: \n";
         for (p = 0; p < 3; p++) {
             for (k = 0; k < 3; k++) {
-                cubePieces[k][p][i].print();
+                piece(k, p, i).print();
                 cout << "\n";
             }
         }
@@ -306,86 +269,49 @@ void AlgoCube::printWholeCube() {
 
 // spins whole cube up along the x axis
 void AlgoCube::spinUp90AlongX() {
-    spinLayerUp90AlongX(0, false, false);
-    spinLayerUp90AlongX(1, false, false);
-    spinLayerUp90AlongX(2, false, false);
+    state.applyMove(0);
 
     moves.push_back(0);
 }
 
 // spins whole cube down along the x axis
 void AlgoCube::spinDown90AlongX() {
-    spinLayerDown90AlongX(0, false, false);
-    spinLayerDown90AlongX(1, false, false);
-    spinLayerDown90AlongX(2, false, false);
+    state.applyMove(1);
 
     moves.push_back(1);
 }
 
 // spins whole cube to the right along the y axis
 void AlgoCube::spinRight90AlongY() {
-    spinLayerRight90AlongY(0, false, false);
-    spinLayerRight90AlongY(1, false, false);
-    spinLayerRight90AlongY(2, false, false);
+    state.applyMove(2);
 
     moves.push_back(2);
 }
 
 // spins whole cube to the left along the y axis
 void AlgoCube::spinLeft90AlongY() {
-    spinLayerLeft90AlongY(0, false, false);
-    spinLayerLeft90AlongY(1, false, false);
-    spinLayerLeft90AlongY(2, false, false);
+    state.applyMove(3);
 
     moves.push_back(3);
 }
 
 // spins whole cube to the right along the z axis
 void AlgoCube::spinRight90AlongZ() {
-    spinLayerRight90AlongZ(0, false, false);
-    spinLayerRight90AlongZ(1, false, false);
-    spinLayerRight90AlongZ(2, false, false);
+    state.applyMove(4);
 
     moves.push_back(4);
 }
 
 // spins whole cube to the left along the z axis
 void AlgoCube::spinLeft90AlongZ() {
-    spinLayerLeft90AlongZ(0, false, false);
-    spinLayerLeft90AlongZ(1, false, false);
-    spinLayerLeft90AlongZ(2, false, false);
+    state.applyMove(5);
 
     moves.push_back(5);
 }
 
 // spins affected layer (0: left, 1: middle, 2: right) up 90 degrees along the x axis
 void AlgoCube::spinLayerUp90AlongX(unsigned xLayer, bool intoMovesArray, bool forRandomize) {
-    unsigned y, z;
-    unsigned x = xLayer;
-    CubePiece tmp;
-
-    for (z = 0; z < 3; z++) {
-        for (y = 0; y < 3; y++) {
-            if (cubePieces[x][y][z].isCornerPiece())
-                cubePieces[x][y][z].prepareCornerPieceMove90AlongX();
-            else if (cubePieces[x][y][z].isEdgePiece())
-                cubePieces[x][y][z].prepareEdgePieceMove90AlongX(z, x);
-        }
-    }
-
-    // moving corner pieces
-    tmp = cubePieces[x][0][2];
-    cubePieces[x][0][2] = cubePieces[x][0][0];
-    cubePieces[x][0][0] = cubePieces[x][2][0];
-    cubePieces[x][2][0] = cubePieces[x][2][2];
-    cubePieces[x][2][2] = tmp;
-
-    // moving edge cubePieces
-    tmp = cubePieces[x][0][1];
-    cubePieces[x][0][1] = cubePieces[x][1][0];
-    cubePieces[x][1][0] = cubePieces[x][2][1];
-    cubePieces[x][2][1] = cubePieces[x][1][2];
-    cubePieces[x][1][2] = tmp;
+    state.applyMove(moveCode(0, xLayer, false));
 
     if (intoMovesArray == true && forRandomize == false) {
         switch (xLayer) {
@@ -417,32 +343,7 @@ void AlgoCube::spinLayerUp90AlongX(unsigned xLayer, bool intoMovesArray, bool fo
 
 // spins affected layer (0: left, 1: middle, 2: right) down 90 degrees along the x axis
 void AlgoCube::spinLayerDown90AlongX(unsigned xLayer, bool intoMovesArray, bool forRandomize) {
-    unsigned y, z;
-    unsigned x = xLayer;
-    CubePiece tmp;
-
-    for (z = 0; z < 3; z++) {
-        for (y = 0; y < 3; y++) {
-            if (cubePieces[x][y][z].isCornerPiece())
-                cubePieces[x][y][z].prepareCornerPieceMove90AlongX();
-            else if (cubePieces[x][y][z].isEdgePiece())
-                cubePieces[x][y][z].prepareEdgePieceMove90AlongX(z, x);
-        }
-    }
-
-    // moving corner pieces
-    tmp = cubePieces[x][2][0];
-    cubePieces[x][2][0] = cubePieces[x][0][0];
-    cubePieces[x][0][0] = cubePieces[x][0][2];
-    cubePieces[x][0][2] = cubePieces[x][2][2];
-    cubePieces[x][2][2] = tmp;
-
-    // moving edge cubePieces
-    tmp = cubePieces[x][1][0];
-    cubePieces[x][1][0] = cubePieces[x][0][1];
-    cubePieces[x][0][1] = cubePieces[x][1][2];
-    cubePieces[x][1][2] = cubePieces[x][2][1];
-    cubePieces[x][2][1] = tmp;
+    state.applyMove(moveCode(0, xLayer, true));
 
     if (intoMovesArray == true && forRandomize == false) {
         switch (xLayer) {
@@ -474,32 +375,7 @@ void AlgoCube::spinLayerDown90AlongX(unsigned xLayer, bool intoMovesArray, bool
 
 // spins the affected layer 90 degrees to the right along y axis
 void AlgoCube::spinLayerRight90AlongY(unsigned yLayer, bool intoMovesArray, bool forRandomize) {
-    unsigned x, z;
-    unsigned y = yLayer;
-    CubePiece tmp;
-
-    for (z = 0; z < 3; z++) {
-        for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isCornerPiece())
-                cubePieces[x][y][z].prepareCornerPieceMove90AlongY();
-            else if (cubePieces[x][y][z].isEdgePiece())
-                cubePieces[x][y][z].prepareEdgePieceMove90AlongY(y);
-        }
-    }
-
-    // moving corner pieces
-    tmp = cubePieces[0][y][2];
-    cubePieces[0][y][2] = cubePieces[0][y][0];
-    cubePieces[0][y][0] = cubePieces[2][y][0];
-    cubePieces[2][y][0] = cubePieces[2][y][2];
-    cubePieces[2][y][2] = tmp;
-
-    // moving edge cubePieces
-    tmp = cubePieces[0][y][1];
-    cubePieces[0][y][1] = cubePieces[1][y][0];
-    cubePieces[1][y][0] = cubePieces[2][y][1];
-    cubePieces[2][y][1] = cubePieces[1][y][2];
-    cubePieces[1][y][2] = tmp;
+    state.applyMove(moveCode(1, yLayer, false));
 
     if (intoMovesArray == true && forRandomize == false) {
         switch (yLayer) {
@@ -530,32 +406,7 @@ void AlgoCube::spinLayerRight90AlongY(unsigned yLayer, bool intoMovesArray, bool
 }
 
 void AlgoCube::spinLayerLeft90AlongY(unsigned yLayer, bool intoMovesArray, bool forRandomize) {
-    unsigned x, z;
-    unsigned y = yLayer;
-    CubePiece tmp;
-
-    for (z = 0; z < 3; z++) {
-        for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isCornerPiece())
-                cubePieces[x][y][z].prepareCornerPieceMove90AlongY();
-            else if (cubePieces[x][y][z].isEdgePiece())
-                cubePieces[x][y][z].prepareEdgePieceMove90AlongY(y);
-        }
-    }
-
-    // moving corner pieces
-    tmp = cubePieces[2][y][0];
-    cubePieces[2][y][0] = cubePieces[0][y][0];
-    cubePieces[0][y][0] = cubePieces[0][y][2];
-    cubePieces[0][y][2] = cubePieces[2][y][2];
-    cubePieces[2][y][2] = tmp;
-
-    // moving edge cubePieces
-    tmp = cubePieces[1][y][0];
-    cubePieces[1][y][0] = cubePieces[0][y][1];
-    cubePieces[0][y][1] = cubePieces[1][y][2];
-    cubePieces[1][y][2] = cubePieces[2][y][1];
-    cubePieces[2][y][1] = tmp;
+    state.applyMove(moveCode(1, yLayer, true));
 
     if (intoMovesArray == true && forRandomize == false) {
         switch (yLayer) {
@@ -587,32 +438,7 @@ void AlgoCube::spinLayerLeft90AlongY(unsigned yLayer, bool intoMovesArray, bool
 
 // spins the affected layer (0: bottom - 1: middle - 2: top) 90 degrees to the right along z axis
 void AlgoCube::spinLayerRight90AlongZ(unsigned zLayer, bool intoMovesArray, bool forRandomize) {
-    unsigned x, y;
-    unsigned z = zLayer;
-    CubePiece tmp;
-
-    for (y = 0; y < 3; y++) {
-        for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isCornerPiece())
-                cubePieces[x][y][z].prepareCornerPieceMove90AlongZ();
-            else if (cubePieces[x][y][z].isEdgePiece())
-                cubePieces[x][y][z].prepareEdgePieceMove90AlongZ();
-        }
-    }
-
-    // moving corner pieces
-    tmp = cubePieces[0][2][z];
-    cubePieces[0][2][z] = cubePieces[0][0][z];
-    cubePieces[0][0][z] = cubePieces[2][0][z];
-    cubePieces[2][0][z] = cubePieces[2][2][z];
-    cubePieces[2][2][z] = tmp;
-
-    // moving edge cubePieces
-    tmp = cubePieces[0][1][z];
-    cubePieces[0][1][z] = cubePieces[1][0][z];
-    cubePieces[1][0][z] = cubePieces[2][1][z];
-    cubePieces[2][1][z] = cubePieces[1][2][z];
-    cubePieces[1][2][z] = tmp;
+    state.applyMove(moveCode(2, zLayer, false));
 
     if (intoMovesArray == true && forRandomize == false) {
         switch (zLayer) {
@@ -644,32 +470,7 @@ void AlgoCube::spinLayerRight90AlongZ(unsigned zLayer, bool intoMovesArray, bool
 
 // spins the affected layer (0: bottom - 1: middle - 2: top) 90 degrees to the left along z axis
 void AlgoCube::spinLayerLeft90AlongZ(unsigned zLayer, bool intoMovesArray, bool forRandomize) {
-    unsigned x, y;
-    unsigned z = zLayer;
-    CubePiece tmp;
-
-    for (y = 0; y < 3; y++) {
-        for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isCornerPiece())
-                cubePieces[x][y][z].prepareCornerPieceMove90AlongZ();
-            else if (cubePieces[x][y][z].isEdgePiece())
-                cubePieces[x][y][z].prepareEdgePieceMove90AlongZ();
-        }
-    }
-
-    // moving corner pieces
-    tmp = cubePieces[2][0][z];
-    cubePieces[2][0][z] = cubePieces[0][0][z];
-    cubePieces[0][0][z] = cubePieces[0][2][z];
-    cubePieces[0][2][z] = cubePieces[2][2][z];
-    cubePieces[2][2][z] = tmp;
-
-    // moving edge cubePieces
-    tmp = cubePieces[1][0][z];
-    cubePieces[1][0][z] = cubePieces[0][1][z];
-    cubePieces[0][1][z] = cubePieces[1][2][z];
-    cubePieces[1][2][z] = cubePieces[2][1][z];
-    cubePieces[2][1][z] = tmp;
+    state.applyMove(moveCode(2, zLayer, true));
 
     if (intoMovesArray == true && forRandomize == false) {
         switch (zLayer) {
@@ -714,16 +515,16 @@ void AlgoCube::buildWhiteFlowerMiddleLayer() {
     z = 1;
     for (y = 0; y < 3; y++) {
         for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isEdgePiece() && cubePieces[x][y][z].edgePieceContainsColor('w')) {
-                if (cubePieces[x][y][z].getColor(0) == 'w') { // means that the white face is on front or back side
+            if (piece(x, y, z).isEdgePiece() && piece(x, y, z).edgePieceContainsColor('w')) {
+                if (piece(x, y, z).getColor(0) == 'w') { // means that the white face is on front or back side
                     counter = 0;
-                    while (cubePieces[x][1][2].getColor(0) == 'w' && counter < 4) { // layer can be turned only if target piece is not white
+                    while (piece(x, 1, 2).getColor(0) == 'w' && counter < 4) { // layer can be turned only if target piece is not white
                         if (counter == 4)
                             return;
                         spinLayerRight90AlongZ(2);
                         counter++;
                     }
-                    if (cubePieces[x][1][2].getColor(0) != 'w') {
+                    if (piece(x, 1, 2).getColor(0) != 'w') {
                         if (y == 0) { // front y layer
                             spinLayerUp90AlongX(x);
                         }
@@ -734,15 +535,15 @@ void AlgoCube::buildWhiteFlowerMiddleLayer() {
                     else
                         return;
                 }
-                else if (cubePieces[x][y][z].getColor(1) == 'w') { // means that the white face is lateral
+                else if (piece(x, y, z).getColor(1) == 'w') { // means that the white face is lateral
                     counter = 0;
-                    while (cubePieces[1][y][2].getColor(1) == 'w' && counter < 4) {
+                    while (piece(1, y, 2).getColor(1) == 'w' && counter < 4) {
                         if (counter == 4)
                             return;
                         spinLayerRight90AlongZ(2);
                         counter++;
                     }
-                    if (cubePieces[1][y][2].getColor(1) != 'w') {
+                    if (piece(1, y, 2).getColor(1) != 'w') {
                         if (x == 0) { // left x layer
                             spinLayerRight90AlongY(y);
                         }
@@ -766,17 +567,17 @@ void AlgoCube::buildWhiteFlowerBottomLayer() {
     z = 0; // bottom z-layer a bit more complicated
     for (y = 0; y < 3; y++) {
         for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isEdgePiece() && cubePieces[x][y][z].edgePieceContainsColor('w')) {
+            if (piece(x, y, z).isEdgePiece() && piece(x, y, z).edgePieceContainsColor('w')) {
                 if (x == 0 || x == 2) { // lateral x layers
-                    if (cubePieces[x][y][z].getColor(0) == 'w') { // means that the white face is on bottom of the cube
+                    if (piece(x, y, z).getColor(0) == 'w') { // means that the white face is on bottom of the cube
                         counter = 0;
-                        while (cubePieces[x][1][2].getColor(0) == 'w' && counter < 5) {
+                        while (piece(x, 1, 2).getColor(0) == 'w' && counter < 5) {
                             if (counter == 4)
                                 return;
                             spinLayerRight90AlongZ(2);
                             counter++;
                         }
-                        if (cubePieces[x][1][2].getColor(0) != 'w') {
+                        if (piece(x, 1, 2).getColor(0) != 'w') {
                             // turn the layer 180 degrees and insert piece in opposite side of cube
                             spinLayerUp90AlongX(x);
                             spinLayerUp90AlongX(x);
@@ -784,15 +585,15 @@ void AlgoCube::buildWhiteFlowerBottomLayer() {
                         else
                             return;
                     }
-                    else if (cubePieces[x][y][z].getColor(1) == 'w') { // white face is not on the bottom but on the side --> we need to turn the layer if possible and then insert like in z=1
+                    else if (piece(x, y, z).getColor(1) == 'w') { // white face is not on the bottom but on the side --> we need to turn the layer if possible and then insert like in z=1
                         counter = 0;
-                        while (cubePieces[x][1][2].getColor(0) == 'w' && counter < 5) {
+                        while (piece(x, 1, 2).getColor(0) == 'w' && counter < 5) {
                             if (counter == 4)
                                 return;
                             spinLayerRight90AlongZ(2);
                             counter++;
                         }
-                        if (cubePieces[x][1][2].getColor(0) != 'w') {
+                        if (piece(x, 1, 2).getColor(0) != 'w') {
                             spinLayerUp90AlongX(x); // piece gets inserted in top layer in the next loop
 
                         }
@@ -801,15 +602,15 @@ void AlgoCube::buildWhiteFlowerBottomLayer() {
                     }
                 }
                 else if (x == 1) {
-                    if (cubePieces[x][y][z].getColor(1) == 'w') { // means that the white face is on bottom of the cube
+                    if (piece(x, y, z).getColor(1) == 'w') { // means that the white face is on bottom of the cube
                         counter = 0;
-                        while (cubePieces[1][y][2].getColor(1) == 'w' && counter < 5) {
+                        while (piece(1, y, 2).getColor(1) == 'w' && counter < 5) {
                             if (counter == 4)
                                 return;
                             spinLayerRight90AlongZ(2);
                             counter++;
                         }
-                        if (cubePieces[1][y][2].getColor(1) != 'w') {
+                        if (piece(1, y, 2).getColor(1) != 'w') {
                             spinLayerRight90AlongY(y);
                             spinLayerRight90AlongY(y);
                         }
@@ -817,15 +618,15 @@ void AlgoCube::buildWhiteFlowerBottomLayer() {
                             return;
                         }
                     }
-                    else if (cubePieces[x][y][z].getColor(0) == 'w') { // white face is not on the bottom but on the side --> we need to turn the layer if possible and then insert like in z=1
+                    else if (piece(x, y, z).getColor(0) == 'w') { // white face is not on the bottom but on the side --> we need to turn the layer if possible and then insert like in z=1
                         counter = 0;
-                        while (cubePieces[1][y][2].getColor(1) == 'w' && counter < 5) {
+                        while (piece(1, y, 2).getColor(1) == 'w' && counter < 5) {
                             if (counter == 4)
                                 return;
                             spinLayerRight90AlongZ(2);
                             counter++;
                         }
-                        if (cubePieces[1][y][2].getColor(0) != 'w') {
+                        if (piece(1, y, 2).getColor(0) != 'w') {
                             spinLayerRight90AlongY(y); // piece gets inserted in top layer in the next loop
 
                         }
@@ -844,14 +645,14 @@ void AlgoCube::buildWhiteFlowerTopLayer() {
     z = 2;
     for (y = 0; y < 3; y++) {
         for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isEdgePiece() && cubePieces[x][y][z].edgePieceContainsColor('w')) {
+            if (piece(x, y, z).isEdgePiece() && piece(x, y, z).edgePieceContainsColor('w')) {
                 if (x == 0 || x == 2) {
-                    if (cubePieces[x][y][z].getColor(1) == 'w') {
+                    if (piece(x, y, z).getColor(1) == 'w') {
                         spinLayerDown90AlongX(x);
                     }
                 }
                 else if (x == 1) {
-                    if (cubePieces[x][y][z].getColor(0) == 'w') {
+                    if (piece(x, y, z).getColor(0) == 'w') {
                         spinLayerRight90AlongY(y);
                     }
                 }
@@ -870,7 +671,8 @@ void AlgoCube::buildWhiteFlower() {
         buildWhiteFlowerTopLayer();
         counter++;
     }
-    cout << "white flower built" << endl;
+    if (verbose)
+        cout << "white flower built" << endl;
 }
 
 void AlgoCube::buildWhiteCross() {
@@ -884,9 +686,9 @@ void AlgoCube::buildWhiteCross() {
         z = 2; // top layer
         for (y = 0; y < 3; y++) {
             for (x = 0; x < 3; x++) {
-                if (cubePieces[x][y][z].isEdgePiece() && x == 1 && cubePieces[x][y][z].isColorOnTopOfEdgePiece('w', x)) {
+                if (piece(x, y, z).isEdgePiece() && x == 1 && piece(x, y, z).isColorOnTopOfEdgePiece('w', x)) {
                     counter = 0;
-                    while (cubePieces[x][y][z].getColor(0) != cubePieces[x][y][z-1].getColor(0)) {
+                    while (piece(x, y, z).getColor(0) != piece(x, y, z-1).getColor(0)) {
                         if (counter > 4) {
                             if (isWhiteCrossOnBottom())
                                 return;
@@ -895,7 +697,7 @@ void AlgoCube::buildWhiteCross() {
                         spinLayerRight90AlongZ(1);
                         counter++;
                     }
-                    if (cubePieces[x][y][z].getColor(0) == cubePieces[x][y][z-1].getColor(0)) {
+                    if (piece(x, y, z).getColor(0) == piece(x, y, z-1).getColor(0)) {
                         spinLayerRight90AlongY(y);
                         spinLayerRight90AlongY(y);
                     }
@@ -904,9 +706,9 @@ void AlgoCube::buildWhiteCross() {
                         exit(1);
                     }
                 }
-                else if (cubePieces[x][y][z].isEdgePiece() && (x == 0 || x == 2) && cubePieces[x][y][z].isColorOnTopOfEdgePiece('w', x)) {
+                else if (piece(x, y, z).isEdgePiece() && (x == 0 || x == 2) && piece(x, y, z).isColorOnTopOfEdgePiece('w', x)) {
                     counter = 0;
-                    while (cubePieces[x][y][z].getColor(1) != cubePieces[x][y][z-1].getColor(0)) {
+                    while (piece(x, y, z).getColor(1) != piece(x, y, z-1).getColor(0)) {
                         if (counter > 4) {
                             if (isWhiteCrossOnBottom())
                                 return;
@@ -915,7 +717,7 @@ void AlgoCube::buildWhiteCross() {
                         spinLayerRight90AlongZ(1);
                         counter++;
                     }
-                    if (cubePieces[x][y][z].getColor(1) == cubePieces[x][y][z-1].getColor(0)) {
+                    if (piece(x, y, z).getColor(1) == piece(x, y, z-1).getColor(0)) {
                         spinLayerDown90AlongX(x);
                         spinLayerDown90AlongX(x);
                     }
@@ -927,7 +729,8 @@ void AlgoCube::buildWhiteCross() {
             }
         }
     }
-    cout << "white cross built" << endl;
+    if (verbose)
+        cout << "white cross built" << endl;
 }
 
 void AlgoCube::solveFirstLayer() {
@@ -942,13 +745,14 @@ void AlgoCube::solveFirstLayer() {
         nextCornerX = turnCubeUntilWhiteBottomCornerFront();
         insertNextWhiteCornerPiece(nextCornerX);
     }
-    cout << "solved first (white) layer" << endl;
+    if (verbose)
+        cout << "solved first (white) layer" << endl;
 
 }
 
 void AlgoCube::insertNextWhiteCornerPiece(unsigned x) {
     if (x == 0) {               // bottom side                      // front surface                    // lateral side                 // lateral surface
-        while (!(cubePieces[x][0][0].getColor(1) == cubePieces[1][0][1].getColor(0) && cubePieces[x][0][0].getColor(2) == cubePieces[x][1][1].getColor(0))) {
+        while (!(piece(x, 0, 0).getColor(1) == piece(1, 0, 1).getColor(0) && piece(x, 0, 0).getColor(2) == piece(x, 1, 1).getColor(0))) {
             spinLayerRight90AlongZ(2);
             spinLayerRight90AlongZ(1);
         }
@@ -958,7 +762,7 @@ void AlgoCube::insertNextWhiteCornerPiece(unsigned x) {
         spinLayerUp90AlongX(x);
     }
     else if (x == 2) {
-        while (!(cubePieces[x][0][0].getColor(1) == cubePieces[1][0][1].getColor(0) && cubePieces[x][0][0].getColor(2) == cubePieces[x][1][1].getColor(0))) {
+        while (!(piece(x, 0, 0).getColor(1) == piece(1, 0, 1).getColor(0) && piece(x, 0, 0).getColor(2) == piece(x, 1, 1).getColor(0))) {
             spinLayerRight90AlongZ(2);
             spinLayerRight90AlongZ(1);
         }
@@ -1031,9 +835,9 @@ void AlgoCube::bringTopWhiteCornerFront() {
     z = 2;
     for (y = 0; y < 3; y++) {
         for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isCornerPiece()) {
+            if (piece(x, y, z).isCornerPiece()) {
                 if (!isCornerPieceCorrect(x, y, 'w')) { // when cornerpice is incorrect
-                    if (cubePieces[x][y][z].getPositionOfColor('w') != -1) { // has white in it
+                    if (piece(x, y, z).getPositionOfColor('w') != -1) { // has white in it
                         dismantleIncorrectWhiteCornerPiece(x, y); // brings piece to bottom layer where it can be inserted more easily
                     }
                 }
@@ -1062,42 +866,44 @@ void AlgoCube::dismantleIncorrectWhiteCornerPiece(unsigned x, unsigned y) {
     // y == 0
     z = 2;
     if (x == 0) {                           // on top                                        // on the side -> same movements
-        if (cubePieces[x][y][z].getPositionOfColor('w') == 1 || cubePieces[x][y][z].getPositionOfColor('w') == 2) {
+        if (piece(x, y, z).getPositionOfColor('w') == 1 || piece(x, y, z).getPositionOfColor('w') == 2) {
             spinLayerDown90AlongX(x);
             spinLayerLeft90AlongZ(0);
             spinLayerUp90AlongX(x);
         }
-        else if (cubePieces[x][y][z].getPositionOfColor('w') == 0) {
+        else if (piece(x, y, z).getPositionOfColor('w') == 0) {
             spinLayerLeft90AlongY(y);
             spinLayerRight90AlongZ(0);
             spinLayerRight90AlongY(y);
         }
-        else if (cubePieces[x][y][z].getPositionOfColor('w') == -1) {
-            cout << "no white piece to move" << endl;
+        else if (piece(x, y, z).getPositionOfColor('w') == -1) {
+            if (verbose)
+                cout << "no white piece to move" << endl;
         }
     }
     else if (x == 2) {
-        if (cubePieces[x][y][z].getPositionOfColor('w') == 1 || cubePieces[x][y][z].getPositionOfColor('w') == 2) {
+        if (piece(x, y, z).getPositionOfColor('w') == 1 || piece(x, y, z).getPositionOfColor('w') == 2) {
             spinLayerDown90AlongX(x);
             spinLayerRight90AlongZ(0);
             spinLayerUp90AlongX(x);
         }
-        else if (cubePieces[x][y][z].getPositionOfColor('w') == 0) {
+        else if (piece(x, y, z).getPositionOfColor('w') == 0) {
             spinLayerRight90AlongY(y);
             spinLayerLeft90AlongZ(0);
             spinLayerLeft90AlongY(y);
         }
-        else if (cubePieces[x][y][z].getPositionOfColor('w') == -1) {
-            cout << "no white piece to move" << endl;
+        else if (piece(x, y, z).getPositionOfColor('w') == -1) {
+            if (verbose)
+                cout << "no white piece to move" << endl;
         }
     }
 }
 
 // returns 0 if bottom left front corner has a white face and it's on front, 2 if right front corner -"- , else -1
 int AlgoCube::isWhiteBottomCornerFront() {
-    if (cubePieces[0][0][0].getColor(0) == 'w')
+    if (piece(0, 0, 0).getColor(0) == 'w')
         return 0;
-    else if (cubePieces[2][0][0].getColor(0) == 'w')
+    else if (piece(2, 0, 0).getColor(0) == 'w')
         return 2;
     else
         return -1;
@@ -1113,7 +919,7 @@ bool AlgoCube::isFirstLayerSolved() {
         z = 2;
         for (y = 0; y < 3; y++) {
             for (x = 0; x < 3; x++) {
-                if (cubePieces[x][y][z].isCornerPiece()) {
+                if (piece(x, y, z).isCornerPiece()) {
                     if (!isCornerPieceCorrect(x, y, 'w')) {
                         return false;
                     }
@@ -1129,21 +935,21 @@ bool AlgoCube::isFirstLayerSolved() {
 // turns the cube so the yellow surface piece is on top
 void AlgoCube::turnCubeYellowTop() {
 
-    if (cubePieces[1][1][2].getColor(0) != 'y') {
-        if (cubePieces[1][1][0].getColor(0) == 'y') {
+    if (piece(1, 1, 2).getColor(0) != 'y') {
+        if (piece(1, 1, 0).getColor(0) == 'y') {
             spinUp90AlongX();
             spinUp90AlongX();
         }
-        else if (cubePieces[0][1][1].getColor(0) == 'y') {
+        else if (piece(0, 1, 1).getColor(0) == 'y') {
             spinRight90AlongY();
         }
-        else if (cubePieces[2][1][1].getColor(0) == 'y') {
+        else if (piece(2, 1, 1).getColor(0) == 'y') {
             spinLeft90AlongY();
         }
-        else if (cubePieces[1][0][1].getColor(0) == 'y') {
+        else if (piece(1, 0, 1).getColor(0) == 'y') {
             spinUp90AlongX();
         }
-        else if (cubePieces[1][2][1].getColor(0) == 'y') {
+        else if (piece(1, 2, 1).getColor(0) == 'y') {
             spinDown90AlongX();
         }
     }
@@ -1151,9 +957,9 @@ void AlgoCube::turnCubeYellowTop() {
 
 // since function is only being called when white is on bottom, cube is being turned twice along x axis to turn it around
 void AlgoCube::turnCubeWhiteTop() {
-    if (cubePieces[1][1][2].getColor(0) == 'w')
+    if (piece(1, 1, 2).getColor(0) == 'w')
         return;
-    if (cubePieces[1][1][0].getColor(0) == 'w') {
+    if (piece(1, 1, 0).getColor(0) == 'w') {
         spinDown90AlongX();
         spinDown90AlongX();
     }
@@ -1165,7 +971,7 @@ void AlgoCube::turnCubeWhiteTop() {
 
 // returns true if bottom left front corner has a white face and it's on the bottom, else false
 bool AlgoCube::isWhiteBottomCornerLeftBottom() {
-    if (cubePieces[0][0][0].getColor(1) == 'w')
+    if (piece(0, 0, 0).getColor(1) == 'w')
         return true;
     else
         return false;
@@ -1173,16 +979,16 @@ bool AlgoCube::isWhiteBottomCornerLeftBottom() {
 
 // returns true if corner piece is correct -- top layer (z = 2), else false
 bool AlgoCube::isCornerPieceCorrect(unsigned x, unsigned y, char color) {
-    if (!cubePieces[x][y][2].isCornerPiece()) {
+    if (!piece(x, y, 2).isCornerPiece()) {
         cout << "passed piece is no corner piece" << endl;
         exit(1);
     }
     if (x == 0) {
-        if (cubePieces[x][y][2].getColor(1) == color && cubePieces[x][y][2].getColor(0) == cubePieces[1][y][1].getColor(0) && cubePieces[x][y][2].getColor(2) == cubePieces[0][1][1].getColor(0))
+        if (piece(x, y, 2).getColor(1) == color && piece(x, y, 2).getColor(0) == piece(1, y, 1).getColor(0) && piece(x, y, 2).getColor(2) == piece(0, 1, 1).getColor(0))
             return true;
     }
     else if (x == 2) {
-        if (cubePieces[x][y][2].getColor(1) == color && cubePieces[x][y][2].getColor(0) == cubePieces[1][y][1].getColor(0) && cubePieces[x][y][2].getColor(2) == cubePieces[2][1][1].getColor(0))
+        if (piece(x, y, 2).getColor(1) == color && piece(x, y, 2).getColor(0) == piece(1, y, 1).getColor(0) && piece(x, y, 2).getColor(2) == piece(2, 1, 1).getColor(0))
             return true;
     }
     return false;
@@ -1190,9 +996,9 @@ bool AlgoCube::isCornerPieceCorrect(unsigned x, unsigned y, char color) {
 
 // returns true if top layer forms the white flower
 bool AlgoCube::isWhiteFlowerOnTop() {
-    if (cubePieces[1][1][2].getColor(0) == 'y') {
-        if (cubePieces[1][0][2].isColorOnTopOfEdgePiece('w', 1) && cubePieces[0][1][2].isColorOnTopOfEdgePiece('w', 0)
-        && cubePieces[2][1][2].isColorOnTopOfEdgePiece('w', 2) && cubePieces[1][2][2].isColorOnTopOfEdgePiece('w', 1))
+    if (piece(1, 1, 2).getColor(0) == 'y') {
+        if (piece(1, 0, 2).isColorOnTopOfEdgePiece('w', 1) && piece(0, 1, 2).isColorOnTopOfEdgePiece('w', 0)
+        && piece(2, 1, 2).isColorOnTopOfEdgePiece('w', 2) && piece(1, 2, 2).isColorOnTopOfEdgePiece('w', 1))
             return true;
     }
     return false;
@@ -1200,11 +1006,11 @@ bool AlgoCube::isWhiteFlowerOnTop() {
 
 // returns true if bottom layer forms the white cross
 bool AlgoCube::isWhiteCrossOnBottom() {
-    if (cubePieces[1][1][0].getColor(0) == 'w') {
-        if (cubePieces[1][0][0].isColorOnTopOfEdgePiece('w', 1) && edgePieceSecondaryMatchesSurface(1, 0, 0) &&
-        cubePieces[0][1][0].isColorOnTopOfEdgePiece('w', 0) && edgePieceSecondaryMatchesSurface(0, 1, 0) &&
-        cubePieces[2][1][0].isColorOnTopOfEdgePiece('w', 2) && edgePieceSecondaryMatchesSurface(2, 1, 0) &&
-        cubePieces[1][2][0].isColorOnTopOfEdgePiece('w', 1) && edgePieceSecondaryMatchesSurface(1, 2, 0))
+    if (piece(1, 1, 0).getColor(0) == 'w') {
+        if (piece(1, 0, 0).isColorOnTopOfEdgePiece('w', 1) && edgePieceSecondaryMatchesSurface(1, 0, 0) &&
+        piece(0, 1, 0).isColorOnTopOfEdgePiece('w', 0) && edgePieceSecondaryMatchesSurface(0, 1, 0) &&
+        piece(2, 1, 0).isColorOnTopOfEdgePiece('w', 2) && edgePieceSecondaryMatchesSurface(2, 1, 0) &&
+        piece(1, 2, 0).isColorOnTopOfEdgePiece('w', 1) && edgePieceSecondaryMatchesSurface(1, 2, 0))
             return true;
     }
     return false;
@@ -1212,11 +1018,11 @@ bool AlgoCube::isWhiteCrossOnBottom() {
 
 // returns true if top layer forms the white cross
 bool AlgoCube::isColorCrossOnTop(char color) {
-    if (cubePieces[1][1][2].getColor(0) == color) {
-        if (cubePieces[1][0][2].isColorOnTopOfEdgePiece(color, 1) && edgePieceSecondaryMatchesSurface(1, 0, 2) &&
-        cubePieces[0][1][2].isColorOnTopOfEdgePiece(color, 0) && edgePieceSecondaryMatchesSurface(0, 1, 2) &&
-        cubePieces[2][1][2].isColorOnTopOfEdgePiece(color, 2) && edgePieceSecondaryMatchesSurface(2, 1, 2) &&
-        cubePieces[1][2][2].isColorOnTopOfEdgePiece(color, 1) && edgePieceSecondaryMatchesSurface(1, 2, 2))
+    if (piece(1, 1, 2).getColor(0) == color) {
+        if (piece(1, 0, 2).isColorOnTopOfEdgePiece(color, 1) && edgePieceSecondaryMatchesSurface(1, 0, 2) &&
+        piece(0, 1, 2).isColorOnTopOfEdgePiece(color, 0) && edgePieceSecondaryMatchesSurface(0, 1, 2) &&
+        piece(2, 1, 2).isColorOnTopOfEdgePiece(color, 2) && edgePieceSecondaryMatchesSurface(2, 1, 2) &&
+        piece(1, 2, 2).isColorOnTopOfEdgePiece(color, 1) && edgePieceSecondaryMatchesSurface(1, 2, 2))
             return true;
     }
     return false;
@@ -1225,11 +1031,11 @@ bool AlgoCube::isColorCrossOnTop(char color) {
 // returns true if the secondary color (mostly white primary) matches the color of the surface piece above or below
 bool AlgoCube::edgePieceSecondaryMatchesSurface(unsigned x, unsigned y, unsigned z) {
     if (x == 0 || x == 2) {
-        if (cubePieces[x][y][z].getColor(1) == cubePieces[x][y][1].getColor(0))
+        if (piece(x, y, z).getColor(1) == piece(x, y, 1).getColor(0))
             return true;
     }
     else if (x == 1) {
-        if (cubePieces[x][y][z].getColor(0) == cubePieces[x][y][1].getColor(0))
+        if (piece(x, y, z).getColor(0) == piece(x, y, 1).getColor(0))
             return true;
     }
     return false;
@@ -1249,7 +1055,8 @@ void AlgoCube::solveSecondLayer() {
         nextMoveAwayFrom = prepareForNextEdgePieceInsertion();
         insertNextEdgePiece(nextMoveAwayFrom);
     }
-    cout << "solved second layer" << endl;
+    if (verbose)
+        cout << "solved second layer" << endl;
 }
 
 /* looks for next edge piece to be inserted, returns 0 when next move is away from x=0 layer, or 2 when the next move is away from x=2 layer,
@@ -1263,26 +1070,26 @@ int AlgoCube::prepareForNextEdgePieceInsertion() {
     z = 0;
     for (y = 0; y < 3; y++) {
         for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isEdgePiece() && cubePieces[x][y][z].edgePieceContainsColor('y') == false) {
+            if (piece(x, y, z).isEdgePiece() && piece(x, y, z).edgePieceContainsColor('y') == false) {
                 if (x == 1) {
-                    frontColor = cubePieces[x][y][z].getColor(0);
-                    bottomColor = cubePieces[x][y][z].getColor(1);
+                    frontColor = piece(x, y, z).getColor(0);
+                    bottomColor = piece(x, y, z).getColor(1);
                 }
                 else { // if (x == 0 || x == 2) {
-                    frontColor = cubePieces[x][y][z].getColor(1);
-                    bottomColor = cubePieces[x][y][z].getColor(0);
+                    frontColor = piece(x, y, z).getColor(1);
+                    bottomColor = piece(x, y, z).getColor(0);
                 }
 
                 turnCubeColorFront(frontColor);
 
-                while (!(cubePieces[1][0][0].getColor(0) == frontColor && cubePieces[1][0][0].getColor(1) != 'y')) {
+                while (!(piece(1, 0, 0).getColor(0) == frontColor && piece(1, 0, 0).getColor(1) != 'y')) {
                     spinLayerRight90AlongZ(z);
                 }
 
-                if (cubePieces[0][1][1].getColor(0) == bottomColor) {
+                if (piece(0, 1, 1).getColor(0) == bottomColor) {
                     return 0;
                 }
-                else if (cubePieces[2][1][1].getColor(0) == bottomColor) {
+                else if (piece(2, 1, 1).getColor(0) == bottomColor) {
                     return 2;
                 }
             }
@@ -1297,7 +1104,7 @@ int AlgoCube::prepareForNextEdgePieceInsertion() {
         spinRight90AlongZ();
         counter++;
     }
-    if (cubePieces[2][0][1].edgePieceContainsColor('y') == false) {
+    if (piece(2, 0, 1).edgePieceContainsColor('y') == false) {
         spinLayerUp90AlongX(2);
         spinLayerLeft90AlongZ(2);
         spinLayerDown90AlongX(2);
@@ -1332,7 +1139,7 @@ void AlgoCube::insertNextEdgePiece(unsigned awayFrom) {
 void AlgoCube::turnCubeColorFront(char color) {
     turnCubeWhiteTop();
 
-    while (cubePieces[1][0][1].getColor(0) != color) {
+    while (piece(1, 0, 1).getColor(0) != color) {
         spinRight90AlongZ();
     }
 }
@@ -1341,10 +1148,10 @@ bool AlgoCube::isSecondLayerSolved() {
     turnCubeWhiteTop();
 
     if (isFirstLayerSolved()) {
-        if (cubePieces[0][0][1].getColor(0) == cubePieces[1][0][1].getColor(0) && cubePieces[0][0][1].getColor(1) == cubePieces[0][1][1].getColor(0) &&
-        cubePieces[2][0][1].getColor(0) == cubePieces[1][0][1].getColor(0) && cubePieces[2][0][1].getColor(1) == cubePieces[2][1][1].getColor(0) &&
-        cubePieces[0][2][1].getColor(0) == cubePieces[1][2][1].getColor(0) && cubePieces[0][2][1].getColor(1) == cubePieces[0][1][1].getColor(0) &&
-        cubePieces[2][2][1].getColor(0) == cubePieces[1][2][1].getColor(0) && cubePieces[2][2][1].getColor(1) == cubePieces[2][1][1].getColor(0))
+        if (piece(0, 0, 1).getColor(0) == piece(1, 0, 1).getColor(0) && piece(0, 0, 1).getColor(1) == piece(0, 1, 1).getColor(0) &&
+        piece(2, 0, 1).getColor(0) == piece(1, 0, 1).getColor(0) && piece(2, 0, 1).getColor(1) == piece(2, 1, 1).getColor(0) &&
+        piece(0, 2, 1).getColor(0) == piece(1, 2, 1).getColor(0) && piece(0, 2, 1).getColor(1) == piece(0, 1, 1).getColor(0) &&
+        piece(2, 2, 1).getColor(0) == piece(1, 2, 1).getColor(0) && piece(2, 2, 1).getColor(1) == piece(2, 1, 1).getColor(0))
             return true;
     }
     return false;
@@ -1353,18 +1160,18 @@ bool AlgoCube::isSecondLayerSolved() {
 bool AlgoCube::isEdgePieceCorrect(unsigned x, unsigned y) {
     if (y == 0) {
         if (x == 0) {
-            return cubePieces[0][0][1].getColor(0) == cubePieces[1][0][1].getColor(0) && cubePieces[0][0][1].getColor(1) == cubePieces[0][1][1].getColor(0);
+            return piece(0, 0, 1).getColor(0) == piece(1, 0, 1).getColor(0) && piece(0, 0, 1).getColor(1) == piece(0, 1, 1).getColor(0);
         }
         else if (x == 2) {
-            return cubePieces[2][0][1].getColor(0) == cubePieces[1][0][1].getColor(0) && cubePieces[2][0][1].getColor(1) == cubePieces[2][1][1].getColor(0);
+            return piece(2, 0, 1).getColor(0) == piece(1, 0, 1).getColor(0) && piece(2, 0, 1).getColor(1) == piece(2, 1, 1).getColor(0);
         }
     }
     else if (y == 2) {
         if (x == 0) {
-            return cubePieces[0][2][1].getColor(0) == cubePieces[1][2][1].getColor(0) && cubePieces[0][2][1].getColor(1) == cubePieces[0][1][1].getColor(0);
+            return piece(0, 2, 1).getColor(0) == piece(1, 2, 1).getColor(0) && piece(0, 2, 1).getColor(1) == piece(0, 1, 1).getColor(0);
         }
         else if (x == 2) {
-            return cubePieces[2][2][1].getColor(0) == cubePieces[1][2][1].getColor(0) && cubePieces[2][2][1].getColor(1) == cubePieces[2][1][1].getColor(0);
+            return piece(2, 2, 1).getColor(0) == piece(1, 2, 1).getColor(0) && piece(2, 2, 1).getColor(1) == piece(2, 1, 1).getColor(0);
         }
     }
     return false;
@@ -1428,7 +1235,8 @@ void AlgoCube::solveThirdLayer() {
         solveThirdLayer();
     }
     else {
-        cout << "solved third layer" << endl;
+        if (verbose)
+            cout << "solved third layer" << endl;
     }
 }
 
@@ -1443,7 +1251,8 @@ void AlgoCube::buildYellowCross() {
         u_();
         f_();
     }
-    cout << "yellow cross built" << endl;
+    if (verbose)
+        cout << "yellow cross built" << endl;
 }
 
 void AlgoCube::prepareNextStepYellowCross() {
@@ -1458,7 +1267,7 @@ void AlgoCube::prepareNextStepYellowCross() {
     counter = 0;
     for (y = 0; y < 3; y++) {
         for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isEdgePiece() && cubePieces[x][y][z].isColorOnTopOfEdgePiece('y', x))
+            if (piece(x, y, z).isEdgePiece() && piece(x, y, z).isColorOnTopOfEdgePiece('y', x))
                 counter++;
         }
     }
@@ -1467,21 +1276,21 @@ void AlgoCube::prepareNextStepYellowCross() {
         return;
     }
     else if (counter == 2) {
-        while (cubePieces[1][0][2].isColorOnTopOfEdgePiece('y', 1) == false) {
+        while (piece(1, 0, 2).isColorOnTopOfEdgePiece('y', 1) == false) {
             spinRight90AlongZ();
         }
-        if (cubePieces[1][0][2].isColorOnTopOfEdgePiece('y', 1)) {
-            if (cubePieces[1][2][2].isColorOnTopOfEdgePiece('y', 1)) { // yellow line (vertically oriented)
+        if (piece(1, 0, 2).isColorOnTopOfEdgePiece('y', 1)) {
+            if (piece(1, 2, 2).isColorOnTopOfEdgePiece('y', 1)) { // yellow line (vertically oriented)
                 spinRight90AlongZ();
                 // oriented horizontally now
                 return;
             }
-            else if (cubePieces[0][1][2].isColorOnTopOfEdgePiece('y', 0)) { // yellow L to the left edge
+            else if (piece(0, 1, 2).isColorOnTopOfEdgePiece('y', 0)) { // yellow L to the left edge
                 spinLeft90AlongZ();
                 // oriented to the right now
                 return;
             }
-            else if (cubePieces[2][1][2].isColorOnTopOfEdgePiece('y', 2)) { // yellow L to the right edge
+            else if (piece(2, 1, 2).isColorOnTopOfEdgePiece('y', 2)) { // yellow L to the right edge
                 return;
             }
         }
@@ -1525,7 +1334,8 @@ void AlgoCube::connectEdges() {
             u_();
         }
     }
-    cout << "connected edges" << endl;
+    if (verbose)
+        cout << "connected edges" << endl;
 }
 
 // returns 0 if no edges are connected with surface below, 1 if two opposite edges, 2 if two besided edges, 4 if all edges are connected with surfaces below
@@ -1537,7 +1347,7 @@ unsigned AlgoCube::edgesConnected() {
     counter = 0;
     for (y = 0; y < 3; y++) {
         for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isEdgePiece() && edgePieceSecondaryMatchesSurface(x, y, z)) {
+            if (piece(x, y, z).isEdgePiece() && edgePieceSecondaryMatchesSurface(x, y, z)) {
                 counter++;
             }
         }
@@ -1583,7 +1393,8 @@ void AlgoCube::bringCornersIntoCorrectPosition() {
         u_();
         nrCornersCorrectPos = getNrCornerPiecesInCorrectPosition();
     }
-    cout << "positioned corners in third layer correctly" << endl;
+    if (verbose)
+        cout << "positioned corners in third layer correctly" << endl;
 }
 
 // can only return 0, 1 or 4
@@ -1595,7 +1406,7 @@ unsigned AlgoCube::getNrCornerPiecesInCorrectPosition() {
     counter = 0;
     for (y = 0; y < 3; y++) {
         for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isCornerPiece() && isCornerPieceInCorrectPosition(x, y, 'y')) {
+            if (piece(x, y, z).isCornerPiece() && isCornerPieceInCorrectPosition(x, y, 'y')) {
                 counter++;
             }
         }
@@ -1639,7 +1450,8 @@ void AlgoCube::bringCornersIntoCorrectOrientation() {
 
         nrCornersCorrect = getNrCornerPiecesInCorrectOrientation();
     }
-    cout << "orientated corners in third layer correctly" << endl;
+    if (verbose)
+        cout << "orientated corners in third layer correctly" << endl;
 }
 
 // can only return 0, 1, 2, 4
@@ -1651,7 +1463,7 @@ unsigned AlgoCube::getNrCornerPiecesInCorrectOrientation() {
     counter = 0;
     for (y = 0; y < 3; y++) {
         for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isCornerPiece() && isCornerPieceCorrect(x, y, 'y')) {
+            if (piece(x, y, z).isCornerPiece() && isCornerPieceCorrect(x, y, 'y')) {
                 counter++;
             }
         }
@@ -1666,10 +1478,10 @@ bool AlgoCube::isCornerPieceInCorrectPosition(unsigned x, unsigned y, char color
     unsigned z;
 
     z = 2;
-    if (cubePieces[x][y][z].getPositionOfColor(color) != -1) {
-        surfaceColorFrontBack = cubePieces[1][y][1].getColor(0);
-        surfaceColorLeftRight = cubePieces[x][1][1].getColor(0);
-        if (cubePieces[x][y][z].getPositionOfColor(surfaceColorFrontBack) != -1 && cubePieces[x][y][z].getPositionOfColor(surfaceColorLeftRight) != -1) {
+    if (piece(x, y, z).getPositionOfColor(color) != -1) {
+        surfaceColorFrontBack = piece(1, y, 1).getColor(0);
+        surfaceColorLeftRight = piece(x, 1, 1).getColor(0);
+        if (piece(x, y, z).getPositionOfColor(surfaceColorFrontBack) != -1 && piece(x, y, z).getPositionOfColor(surfaceColorLeftRight) != -1) {
             return true;
         }
     }
@@ -1678,10 +1490,10 @@ bool AlgoCube::isCornerPieceInCorrectPosition(unsigned x, unsigned y, char color
 
 // returns true if yellow cross on top (criterias like in isColorCrossOnTop() concerning secondary colors not considered)
 bool AlgoCube::isColorCrossOnTopNoSecondary(char color) {
-    if (cubePieces[1][0][2].isColorOnTopOfEdgePiece(color, 1) &&
-    cubePieces[0][1][2].isColorOnTopOfEdgePiece(color, 0) &&
-    cubePieces[2][1][2].isColorOnTopOfEdgePiece(color, 2) &&
-    cubePieces[1][2][2].isColorOnTopOfEdgePiece(color, 1)) {
+    if (piece(1, 0, 2).isColorOnTopOfEdgePiece(color, 1) &&
+    piece(0, 1, 2).isColorOnTopOfEdgePiece(color, 0) &&
+    piece(2, 1, 2).isColorOnTopOfEdgePiece(color, 2) &&
+    piece(1, 2, 2).isColorOnTopOfEdgePiece(color, 1)) {
         return true;
     }
     return false;
@@ -1695,7 +1507,7 @@ bool AlgoCube::isThirdLayerSolved() {
     z = 2;
     for (y = 0; y < 3; y++) {
         for (x = 0; x < 3; x++) {
-            if (cubePieces[x][y][z].isCornerPiece() && isCornerPieceCorrect(x, y, 'y') == false) {
+            if (piece(x, y, z).isCornerPiece() && isCornerPieceCorrect(x, y, 'y') == false) {
                 return false;
             }
         }
@@ -1709,90 +1521,110 @@ bool AlgoCube::isThirdLayerSolved() {
 
 /////////////////////////////////////////////////////////////////////////////
 
-void AlgoCube::solveRubiksCube() {
-    solveFirstLayer();
-    solveSecondLayer();
-    solveThirdLayer();
+/***    	           OTHER SOLVERS             ***/
+
+// appends the moves of TwoPhaseSolver, half turns become two move codes as the renderer only knows 90 degree turns.
+// Returns false (and keeps the cube) if the state cannot be solved.
+bool AlgoCube::solveTwoPhase() {
+    vector<int> solution;
+
+    if (!TwoPhaseSolver::getInstance().solve(state, &solution)) {
+        cout << "cube cannot be solved: pieces are twisted, flipped or swapped" << endl;
+        return false;
+    }
+    state.applyMoves(solution);
+    moves.insert(moves.end(), solution.begin(), solution.end());
+    return true;
+}
+
+// appends the moves of OptimalSolver, the first call builds the pattern databases. The search statistics go to
+// *stats unless it is NULL, returns false (and keeps the cube) if the state cannot be solved.
+bool AlgoCube::solveOptimal(OptimalStats* stats) {
+    vector<int> solution;
+    OptimalStats search;
+
+    if (!OptimalSolver::getInstance().solve(state, &solution, &search)) {
+        cout << "cube cannot be solved: pieces are twisted, flipped or swapped" << endl;
+        return false;
+    }
+    if (verbose)
+        cout << "optimal solution: " << search.depth << " face turns, " << search.nodes << " nodes in " << search.seconds
+             << " s (" << search.getNodesPerSecond() / 1e6 << " M nodes/s)" << endl;
+    if (stats != NULL)
+        *stats = search;
+    state.applyMoves(solution);
+    moves.insert(moves.end(), solution.begin(), solution.end());
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+// false if the solver found no solution, the moves are then the ones before the call
+bool AlgoCube::solveRubiksCube(SolverType solver) {
+    switch (solver) {
+        case TWO_PHASE:
+            if (!solveTwoPhase())
+                return false;
+            break;
+        case OPTIMAL:
+            if (!solveOptimal())
+                return false;
+            break;
+        default:
+            solveFirstLayer();
+            solveSecondLayer();
+            solveThirdLayer();
+            break;
+    }
+    // the state stays the same, every move dropped is one animation less
+    optimizeMoves(&moves);
+
+    if (verbose)
+        cout << "-- Rubik's Cube solved successfully --" << endl;
+    return true;
+}
+
+// solves any state, not only one made by createRandomCube: the moves start from state. Returns false (and keeps the
+// cube) if state cannot be reached by turning a solved cube, and false if the solver gives up.
+bool AlgoCube::solveState(const CubeState& state, SolverType solver) {
+    StateCheck check = checkState(state);
+
+    if (check != STATE_SOLVABLE) {
+        cout << "cube cannot be solved: " << getStateCheckText(check) << endl;
+        return false;
+    }
+    this->state = state;
+    moves.clear();
+    randomizeCubeMoves.clear();
+    return solveRubiksCube(solver);
+}
 
-    cout << "-- Rubik's Cube solved successfully --" << endl;
+// facelets in the order of FaceCube (U R F D L B), either in the colors ygrwbo or in six symbols named by the centers
+bool AlgoCube::solveFacelets(const string& facelets, SolverType solver) {
+    FaceCube faceCube;
+    CubeState parsed;
 
+    if (!faceCube.setFacelets(facelets) || !faceCube.toCubeState(&parsed)) {
+        cout << "cube cannot be solved: " << getStateCheckText(STATE_BAD_FACELETS) << endl;
+        return false;
+    }
+    return solveState(parsed, solver);
 }
 
 /***    	           BUILD CUBE                ***/
 
 void AlgoCube::initCube() {
-    vector<CubePiece> testCube;
-
-    // first layer:
-    CubePiece c000 = CubePiece("rwb");
-    CubePiece c100 = CubePiece("rw");
-    CubePiece c200 = CubePiece("rwg");
-    CubePiece c010 = CubePiece("wb");
-    CubePiece c110 = CubePiece("w");
-    CubePiece c210 = CubePiece("wg");
-    CubePiece c020 = CubePiece("owb");
-    CubePiece c120 = CubePiece("ow");
-    CubePiece c220 = CubePiece("owg");
-
-    testCube.push_back(c000);
-    testCube.push_back(c100);
-    testCube.push_back(c200);
-    testCube.push_back(c010);
-    testCube.push_back(c110);
-    testCube.push_back(c210);
-    testCube.push_back(c020);
-    testCube.push_back(c120);
-    testCube.push_back(c220);
-
-    // second layer:
-    CubePiece c001 = CubePiece("rb");
-    CubePiece c101 = CubePiece("r");
-    CubePiece c201 = CubePiece("rg");
-    CubePiece c011 = CubePiece("b");
-    CubePiece c111 = CubePiece("-");
-    CubePiece c211 = CubePiece("g");
-    CubePiece c021 = CubePiece("ob");
-    CubePiece c121 = CubePiece("o");
-    CubePiece c221 = CubePiece("og");
-
-    testCube.push_back(c001);
-    testCube.push_back(c101);
-    testCube.push_back(c201);
-    testCube.push_back(c011);
-    testCube.push_back(c111);
-    testCube.push_back(c211);
-    testCube.push_back(c021);
-    testCube.push_back(c121);
-    testCube.push_back(c221);
-
-    // third layer:
-    CubePiece c002 = CubePiece("ryb");
-    CubePiece c102 = CubePiece("ry");
-    CubePiece c202 = CubePiece("ryg");
-    CubePiece c012 = CubePiece("yb");
-    CubePiece c112 = CubePiece("y");
-    CubePiece c212 = CubePiece("yg");
-    CubePiece c022 = CubePiece("oyb");
-    CubePiece c122 = CubePiece("oy");
-    CubePiece c222 = CubePiece("oyg");
-
-    testCube.push_back(c002);
-    testCube.push_back(c102);
-    testCube.push_back(c202);
-    testCube.push_back(c012);
-    testCube.push_back(c112);
-    testCube.push_back(c212);
-    testCube.push_back(c022);
-    testCube.push_back(c122);
-    testCube.push_back(c222);
-
-    setPieces(testCube);
-
+    state.reset();
 }
 
 void AlgoCube::createRandomCube() {
-    srand(time(NULL));
-    unsigned randomLoops = rand() % 40 + 12; // at least 12 moves
+    createRandomCube(getTimeSeed());
+}
+
+// the same seed gives the same scramble (see Scrambler), other threads do not get in the way
+void AlgoCube::createRandomCube(uint64_t seed) {
+    Scrambler scrambler(seed);
+    unsigned randomLoops = scrambler.nextBelow(40) + 12; // at least 12 moves
     unsigned randomMove;
     unsigned randomNrRotations;
     unsigned randomLayer;
@@ -1801,9 +1633,9 @@ void AlgoCube::createRandomCube() {
     cout << "started to rotate cube randomly...\n.\n." << endl;
 
     for (i = 0; i < randomLoops; i++) {
-        randomMove = rand() % 6;
-        randomNrRotations = rand() % 3 + 1;
-        randomLayer = rand() % 3;
+        randomMove = scrambler.nextBelow(6);
+        randomNrRotations = scrambler.nextBelow(3) + 1;
+        randomLayer = scrambler.nextBelow(3);
         switch(randomMove) {
             case 0:
                 for (p = 0; p < randomNrRotations; p++)
@@ -1867,7 +1699,8 @@ int test() {
 
     // cube fails to solve this
 
-    cube.solveRubiksCube();
+    if (!cube.solveRubiksCube())
+        return 1;
     cube.printWholeCube();
 
     cout << "Nr Moves: " << cube.getRandomizeCubeMoves().size() << endl;
@@ -8,10 +8,19 @@
 #include <vector>
 #include <string>
 #include <array>
+#include "cubestate.h"
 
 using namespace std;
 
 class EOFException {};
+struct OptimalStats;
+
+// solvers selectable per call of AlgoCube::solveRubiksCube
+enum SolverType {
+    LAYER_BY_LAYER,     // beginner method, often more than 150 moves
+    TWO_PHASE,          // Kociemba's two-phase algorithm, about 20 face moves
+    OPTIMAL             // IDA* with pattern databases, fewest face moves
+};
 
 class Color {
 private:
@@ -37,10 +46,12 @@ private:
     **       -- consist of only 2 of these 3 orientations         **
     ** SURFACES -- consist of only 1 color at [0]                 **
     ***************************************************************/
-    vector<Color> colors;
+    Color colors[3];
+    unsigned nrColors;
 public:
     CubePiece();
     CubePiece(string colorstring);
+    CubePiece(const char* colors, unsigned nrColors);
     void setColors(string colorstring);
     char getColor(unsigned index);
     string getColors();
@@ -48,12 +59,6 @@ public:
     bool isCornerPiece();
     bool isEdgePiece();
     bool isSurfacePiece();
-    void prepareCornerPieceMove90AlongX();
-    void prepareEdgePieceMove90AlongX(unsigned z, unsigned x);
-    void prepareCornerPieceMove90AlongY();
-    void prepareEdgePieceMove90AlongY(unsigned y);
-    void prepareCornerPieceMove90AlongZ();
-    void prepareEdgePieceMove90AlongZ();
 
     int getPositionOfColor(char color);
     bool isColorOnTopOfEdgePiece(char color, unsigned x);
@@ -64,18 +69,25 @@ public:
 class AlgoCube {
 private:
     //      [x: left->right] [y: front->back] [z: bottom->top]
-    CubePiece cubePieces[3][3][3];
+    CubeState state;
     vector<int> moves;
     vector<int> randomizeCubeMoves;
+    bool verbose;               // progress messages of the layer solver
+
+    CubePiece piece(unsigned x, unsigned y, unsigned z);
 public:
     AlgoCube();
     AlgoCube(vector<CubePiece> pieces);
     void setPieces(vector<CubePiece> pieces);
     void initCube();
     AlgoCube getCube();
+    CubeState getState();
+    void setState(CubeState state);
     vector<int> getMoves();
     vector<int> getRandomizeCubeMoves();
+    void setVerbose(bool verbose);
     void createRandomCube();
+    void createRandomCube(uint64_t seed);
     void printFirstLayer();
     void printWholeCube();
     void spinUp90AlongX();
@@ -152,7 +164,14 @@ public:
     bool isColorCrossOnTopNoSecondary(char color);
     bool isThirdLayerSolved();
 
-    void solveRubiksCube();
+    // other solvers
+
+    bool solveTwoPhase();
+    bool solveOptimal(OptimalStats* stats=NULL);
+
+    bool solveRubiksCube(SolverType solver=LAYER_BY_LAYER);
+    bool solveState(const CubeState& state, SolverType solver=LAYER_BY_LAYER);
+    bool solveFacelets(const string& facelets, SolverType solver=LAYER_BY_LAYER);
 };
 
 #endif
@@ -0,0 +1,253 @@
+/* standard includes */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "scramblecorpus.h"
+#include "patterndb.h"
+
+using namespace std;
+
+const size_t CORPUS_BUFFER = 4096;          // records collected before they go to the file
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+static const char corpusMagic[8] = {'R', 'C', 'S', 'C', 'R', 'A', 'M', '\0'};
+
+
+/**********************************************************************
+**                        FUNCTION DEFINITIONS                       **
+**********************************************************************/
+
+void packState(const CubeState& state, CorpusRecord* record) {
+    uint64_t corners = 0, edges = 0;
+    unsigned i;
+
+    for (i = 0; i < 8; i++)
+        corners |= (uint64_t) state.corners[i] << 5 * i;
+    for (i = 0; i < 6; i++)
+        corners |= (uint64_t) state.centers[i] << (40 + 3 * i);
+    for (i = 0; i < 12; i++)
+        edges |= (uint64_t) state.edges[i] << 5 * i;
+    record->corners = corners;
+    record->edges = edges;
+}
+
+// the padding of state stays as it is (zero), a move shuffles it along
+void unpackState(const CorpusRecord& record, CubeState* state) {
+    unsigned i;
+
+    for (i = 0; i < 8; i++)
+        state->corners[i] = record.corners >> 5 * i & 31;
+    for (i = 0; i < 6; i++)
+        state->centers[i] = record.corners >> (40 + 3 * i) & 7;
+    for (i = 0; i < 12; i++)
+        state->edges[i] = record.edges >> 5 * i & 31;
+}
+
+// the states of count streams from firstStream, generated on every core in batches of CORPUS_BATCH so memory stays
+// small for any count
+bool writeScrambleCorpus(const string& path, uint64_t seed, ScrambleMode mode, unsigned length, uint64_t count,
+                         uint64_t firstStream) {
+    ScrambleCorpusWriter writer;
+    vector<CubeState> states(CORPUS_BATCH);
+    uint64_t done;
+    size_t batch;
+
+    if (!writer.open(path, seed, mode, length, firstStream))
+        return false;
+    for (done = 0; done < count; done += batch) {
+        batch = count - done < CORPUS_BATCH ? count - done : CORPUS_BATCH;
+        generateScrambles(seed, mode, length, firstStream + done, batch, states.data(), NULL);
+        if (!writer.write(states.data(), batch))
+            return false;
+    }
+    return writer.close();
+}
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+ScrambleCorpusWriter::ScrambleCorpusWriter() {
+    file = NULL;
+    memset(&header, 0, sizeof(header));
+}
+
+// a writer never closed leaves no corpus behind
+ScrambleCorpusWriter::~ScrambleCorpusWriter() {
+    if (file != NULL) {
+        fclose(file);
+        remove((path + ".tmp").c_str());
+    }
+}
+
+// records go to path + ".tmp" until close, the header describes how they were made
+bool ScrambleCorpusWriter::open(const string& path, uint64_t seed, ScrambleMode mode, unsigned length,
+                                uint64_t firstStream) {
+    char padding[CORPUS_DATA_OFFSET];
+
+    if (file != NULL)
+        return false;
+    this->path = path;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, corpusMagic, sizeof(corpusMagic));
+    header.version = CORPUS_FILE_VERSION;
+    header.recordSize = sizeof(CorpusRecord);
+    header.seed = seed;
+    header.firstStream = firstStream;
+    header.generatorVersion = SCRAMBLER_VERSION;
+    header.mode = mode;
+    header.length = mode == SCRAMBLE_MOVES ? length : 0;
+    header.checksum = CHECKSUM_START;
+    buffer.clear();
+    buffer.reserve(CORPUS_BUFFER);
+
+    file = fopen((path + ".tmp").c_str(), "wb");
+    if (file == NULL) {
+        fprintf(stderr, "%s: cannot write the corpus\n", path.c_str());
+        return false;
+    }
+    // the header is only known at the end, until then the space is kept free
+    memset(padding, 0, sizeof(padding));
+    if (fwrite(padding, sizeof(padding), 1, file) != 1) {
+        fclose(file);
+        file = NULL;
+        remove((path + ".tmp").c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ScrambleCorpusWriter::flush() {
+    if (buffer.empty())
+        return true;
+    header.checksum = patternChecksum((const uint8_t*) buffer.data(), buffer.size() * sizeof(CorpusRecord), header.checksum);
+    if (fwrite(buffer.data(), sizeof(CorpusRecord), buffer.size(), file) != buffer.size()) {
+        fprintf(stderr, "%s: cannot write the corpus\n", path.c_str());
+        return false;
+    }
+    header.count += buffer.size();
+    buffer.clear();
+    return true;
+}
+
+bool ScrambleCorpusWriter::write(const CubeState& state) {
+    CorpusRecord record;
+
+    if (file == NULL)
+        return false;
+    packState(state, &record);
+    buffer.push_back(record);
+    return buffer.size() < CORPUS_BUFFER || flush();
+}
+
+bool ScrambleCorpusWriter::write(const CubeState* states, size_t count) {
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        if (!write(states[i]))
+            return false;
+    }
+    return true;
+}
+
+// writes the rest of the records and the header and renames the file, processes mapping an old corpus keep their copy
+bool ScrambleCorpusWriter::close() {
+    string temporary = path + ".tmp";
+    bool ok;
+
+    if (file == NULL)
+        return false;
+    ok = flush() && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = fclose(file) == 0 && ok;
+    file = NULL;
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+        fprintf(stderr, "%s: cannot write the corpus\n", path.c_str());
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+ScrambleCorpus::ScrambleCorpus() {
+    mapping = NULL;
+    mappingSize = 0;
+    header = NULL;
+    records = NULL;
+}
+
+ScrambleCorpus::~ScrambleCorpus() {
+    release();
+}
+
+void ScrambleCorpus::release() {
+    if (mapping != NULL)
+        munmap(mapping, mappingSize);
+    mapping = NULL;
+    mappingSize = 0;
+    header = NULL;
+    records = NULL;
+}
+
+// maps the corpus read-only, returns false if it is missing or no corpus of this version. The checksum is not checked
+// here as that would page in the whole file, see verify. The count is compared by division, a damaged header could
+// make count * sizeof(CorpusRecord) overflow.
+bool ScrambleCorpus::load(const string& path) {
+    CorpusFileHeader fileHeader;
+    struct stat status;
+    void* mapped;
+    int fd;
+
+    release();
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: cannot open the corpus\n", path.c_str());
+        return false;
+    }
+    if (fstat(fd, &status) != 0 || read(fd, &fileHeader, sizeof(fileHeader)) != (ssize_t) sizeof(fileHeader)
+        || memcmp(fileHeader.magic, corpusMagic, sizeof(corpusMagic)) != 0 || fileHeader.version != CORPUS_FILE_VERSION
+        || fileHeader.recordSize != sizeof(CorpusRecord)
+        || (uint64_t) status.st_size < CORPUS_DATA_OFFSET
+        || fileHeader.count > ((uint64_t) status.st_size - CORPUS_DATA_OFFSET) / sizeof(CorpusRecord)) {
+        fprintf(stderr, "%s: no valid corpus of version %u\n", path.c_str(), CORPUS_FILE_VERSION);
+        close(fd);
+        return false;
+    }
+    // the records are only the states, made by another scrambler they no longer match seed and streams
+    if (fileHeader.generatorVersion != SCRAMBLER_VERSION)
+        fprintf(stderr, "%s: made by scrambler version %u, this is version %u\n", path.c_str(),
+                fileHeader.generatorVersion, SCRAMBLER_VERSION);
+
+    mappingSize = CORPUS_DATA_OFFSET + fileHeader.count * sizeof(CorpusRecord);
+    mapped = mmap(NULL, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "%s: cannot map the corpus\n", path.c_str());
+        mappingSize = 0;
+        return false;
+    }
+    // runs mostly go through the corpus in order, the kernel may read ahead
+    madvise(mapped, mappingSize, MADV_SEQUENTIAL);
+
+    mapping = mapped;
+    header = (const CorpusFileHeader*) mapped;
+    records = (const CorpusRecord*) ((const uint8_t*) mapped + CORPUS_DATA_OFFSET);
+    return true;
+}
+
+// recomputes the checksum over all records
+bool ScrambleCorpus::verify() const {
+    if (mapping == NULL)
+        return false;
+    return header->checksum == patternChecksum((const uint8_t*) records, header->count * sizeof(CorpusRecord));
+}
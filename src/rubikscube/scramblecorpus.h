@@ -0,0 +1,124 @@
+// header file for scramblecorpus.cc
+
+#ifndef SCRAMBLECORPUS_H
+#define SCRAMBLECORPUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <vector>
+#include <string>
+#include "cubestate.h"
+#include "scrambler.h"
+
+using namespace std;
+
+const uint32_t CORPUS_FILE_VERSION = 1;
+const unsigned CORPUS_DATA_OFFSET = 4096;   // records start page aligned behind the header
+const size_t CORPUS_BATCH = 1 << 16;        // states generated and written at a time by writeScrambleCorpus
+
+struct CorpusRecord {
+    /***************************************************************
+    ** One state in 16 bytes, both words little endian. Slot i    **
+    ** holds the CubeState byte of that slot (below 32) in bits   **
+    ** 5*i to 5*i+4: corners with their twist and the centers in  **
+    ** 3 bits each from bit 40 in the first word, edges with      **
+    ** their flip in the second.                                  **
+    ***************************************************************/
+    uint64_t corners;
+    uint64_t edges;
+};
+
+struct CorpusFileHeader {
+    /***************************************************************
+    ** Header of a scramble corpus, all fields little endian.     **
+    ** count records follow at CORPUS_DATA_OFFSET, record i is    **
+    ** the scramble of stream firstStream + i of the Scrambler    **
+    ** (generatorVersion) under seed, so a corpus can always be   **
+    ** made again. The checksum is FNV-1a (64 bit) over the       **
+    ** records.                                                   **
+    ***************************************************************/
+    char magic[8];              // "RCSCRAM" and a zero byte
+    uint32_t version;           // CORPUS_FILE_VERSION
+    uint32_t recordSize;        // sizeof(CorpusRecord)
+    uint64_t count;
+    uint64_t seed;
+    uint64_t firstStream;
+    uint32_t generatorVersion;  // SCRAMBLER_VERSION
+    uint32_t mode;              // ScrambleMode
+    uint32_t length;            // face moves of SCRAMBLE_MOVES, 0 for random states
+    uint32_t reserved;
+    uint64_t checksum;
+};
+
+void packState(const CubeState& state, CorpusRecord* record);
+void unpackState(const CorpusRecord& record, CubeState* state);
+
+class ScrambleCorpusWriter {
+private:
+    /***************************************************************
+    ** Writes a corpus one state after the other through a        **
+    ** buffered stream, so any number of states fits in little    **
+    ** memory. The header is written last (count, checksum), the  **
+    ** file only gets its name then: a corpus on disk is always   **
+    ** complete.                                                  **
+    ***************************************************************/
+    FILE* file;
+    string path;
+    CorpusFileHeader header;
+    vector<CorpusRecord> buffer;
+
+    ScrambleCorpusWriter(const ScrambleCorpusWriter&);
+    ScrambleCorpusWriter& operator=(const ScrambleCorpusWriter&);
+
+    bool flush();
+
+public:
+    ScrambleCorpusWriter();
+    ~ScrambleCorpusWriter();
+
+    bool open(const string& path, uint64_t seed, ScrambleMode mode, unsigned length, uint64_t firstStream=0);
+    bool write(const CubeState& state);
+    bool write(const CubeState* states, size_t count);
+    bool close();
+    uint64_t getCount() const { return header.count; }
+};
+
+class ScrambleCorpus {
+private:
+    /***************************************************************
+    ** A corpus mapped read-only: the records are used where they **
+    ** are in the mapping, opening costs the same for 10 states   **
+    ** and for 10 million, and only the pages read are loaded.    **
+    ***************************************************************/
+    void* mapping;
+    size_t mappingSize;
+    const CorpusFileHeader* header;
+    const CorpusRecord* records;
+
+    ScrambleCorpus(const ScrambleCorpus&);
+    ScrambleCorpus& operator=(const ScrambleCorpus&);
+
+public:
+    ScrambleCorpus();
+    ~ScrambleCorpus();
+
+    bool load(const string& path);
+    void release();
+    bool verify() const;
+
+    uint64_t getCount() const { return header != NULL ? header->count : 0; }
+    uint64_t getSeed() const { return header->seed; }
+    uint64_t getFirstStream() const { return header->firstStream; }
+    uint32_t getGeneratorVersion() const { return header->generatorVersion; }
+    ScrambleMode getMode() const { return (ScrambleMode) header->mode; }
+    unsigned getLength() const { return header->length; }
+
+    const CorpusRecord* getRecords() const { return records; }
+    void get(uint64_t index, CubeState* state) const { unpackState(records[index], state); }
+};
+
+bool writeScrambleCorpus(const string& path, uint64_t seed, ScrambleMode mode, unsigned length, uint64_t count,
+                         uint64_t firstStream=0);
+
+#endif
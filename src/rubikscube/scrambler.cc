@@ -0,0 +1,262 @@
+/* standard includes */
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <chrono>
+#include "scrambler.h"
+#include "cubecoords.h"
+#include "threadpool.h"
+#include "twophase.h"
+#include "moveoptimizer.h"
+
+using namespace std;
+
+const uint32_t PHILOX_M0 = 0xD2511F53;
+const uint32_t PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9;     // key schedule, golden ratio
+const uint32_t PHILOX_W1 = 0xBB67AE85;     // sqrt(3) - 1
+
+const size_t SCRAMBLE_CHUNK = 4096;         // scrambles per task of generateScrambles
+
+// faces that may follow each face (NO_FACE at the start), in ascending order
+struct FaceChoices {
+    unsigned count[NO_FACE + 1];
+    uint8_t faces[NO_FACE + 1][6];
+};
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+// permutation of n (up to 12) cubies from its Lehmer digits: p[i] is the digits[i]-th cubie not placed before. Each
+// digit counts the inversions with the cubies after it, so their sum has the parity of the permutation.
+static void lehmerDecode(const uint8_t* digits, uint8_t* p, unsigned n) {
+    uint8_t available[12];
+    unsigned i;
+
+    for (i = 0; i < n; i++)
+        available[i] = i;
+    for (i = 0; i < n; i++) {
+        p[i] = available[digits[i]];
+        memmove(available + digits[i], available + digits[i] + 1, n - i - digits[i] - 1);
+    }
+}
+
+
+static FaceChoices makeFaceChoices() {
+    FaceChoices choices;
+    unsigned lastFace, face;
+
+    for (lastFace = 0; lastFace <= NO_FACE; lastFace++) {
+        choices.count[lastFace] = 0;
+        for (face = 0; face < 6; face++) {
+            if (!isRedundantFace(face, lastFace))
+                choices.faces[lastFace][choices.count[lastFace]++] = face;
+        }
+    }
+    return choices;
+}
+
+static const FaceChoices& faceChoices() {
+    static const FaceChoices choices = makeFaceChoices();
+    return choices;
+}
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+Scrambler::Scrambler(uint64_t seed, uint64_t stream) {
+    key[0] = (uint32_t) seed;
+    key[1] = (uint32_t) (seed >> 32);
+    seek(stream);
+}
+
+void Scrambler::seek(uint64_t stream, uint64_t counter) {
+    this->stream = stream;
+    this->counter = counter;
+    used = 4;
+}
+
+void Scrambler::nextBlock() {
+    uint32_t input[4] = {(uint32_t) counter, (uint32_t) (counter >> 32), (uint32_t) stream, (uint32_t) (stream >> 32)};
+    philox4x32(input, key, block);
+    counter++;
+    used = 0;
+}
+
+uint32_t Scrambler::next() {
+    if (used == 4)
+        nextBlock();
+    return block[used++];
+}
+
+// uniform below bound (Lemire: the high word of a 32x32 bit product, the few low words that would favour some results
+// are drawn again)
+unsigned Scrambler::nextBelow(unsigned bound) {
+    uint64_t product = (uint64_t) next() * bound;
+    uint32_t threshold;
+
+    if ((uint32_t) product < bound) {
+        threshold = -bound % bound;
+        while ((uint32_t) product < threshold)
+            product = (uint64_t) next() * bound;
+    }
+    return product >> 32;
+}
+
+// every solvable state with the centers at home equally likely, straight from three random words: the corner
+// permutation with the twists, the edge permutation and the flips. Half the edge permutations have the parity of the
+// corners, so the edge word only covers 12!/2 and the second to last Lehmer digit (radix 2) makes up the parity.
+void Scrambler::randomState(CubeState* state) {
+    uint32_t corners = nextBelow(NR_PERMS * NR_TWISTS);
+    uint32_t edges = nextBelow(NR_EDGE_PERMS / 2);
+    uint32_t flips = next() % NR_FLIPS;
+    uint32_t perm = corners / NR_TWISTS;
+    uint8_t digits[12];
+    unsigned parity = 0;
+    int i;
+
+    state->reset();
+    for (i = 7; i >= 0; i--) {
+        digits[i] = perm % (8 - i);
+        perm /= 8 - i;
+        parity += digits[i];
+    }
+    lehmerDecode(digits, state->corners, 8);
+    setTwist(state, corners % NR_TWISTS);
+
+    digits[11] = 0;
+    for (i = 9; i >= 0; i--) {
+        digits[i] = edges % (12 - i);
+        edges /= 12 - i;
+        parity += digits[i];
+    }
+    digits[10] = parity & 1;
+    lehmerDecode(digits, state->edges, 12);
+    setFlip(state, flips);
+}
+
+// face moves (3*face + power-1 of cubecoords.h) drawn from the faces that are not redundant after the last one
+void Scrambler::randomFaceMoves(unsigned length, uint8_t* faceMoves) {
+    const FaceChoices& choices = faceChoices();
+    unsigned lastFace = NO_FACE, face, choice, i;
+
+    for (i = 0; i < length; i++) {
+        choice = nextBelow(3 * choices.count[lastFace]);
+        face = choices.faces[lastFace][choice / 3];
+        faceMoves[i] = 3 * face + choice % 3;
+        lastFace = face;
+    }
+}
+
+// state after the scramble, from the solved cube. moves (may be NULL) gets the move codes that turn the solved cube
+// into state, random states only get them from the solver (see getScrambleMoves).
+void Scrambler::scramble(ScrambleMode mode, unsigned length, CubeState* state, vector<int>* moves) {
+    uint8_t buffer[64];
+    vector<uint8_t> longMoves;
+    uint8_t* faceMoves = buffer;
+    unsigned i;
+
+    if (mode == SCRAMBLE_RANDOM_STATE) {
+        randomState(state);
+        if (moves != NULL)
+            getScrambleMoves(*state, moves);
+        return;
+    }
+    if (length > sizeof(buffer)) {
+        longMoves.resize(length);
+        faceMoves = &longMoves[0];
+    }
+    randomFaceMoves(length, faceMoves);
+    state->reset();
+    applyFaceMoves(state, faceMoves, length);
+    if (moves != NULL) {
+        for (i = 0; i < length; i++)
+            appendFaceMove(faceMoves[i], moves);
+    }
+}
+
+
+/**********************************************************************
+**                        FUNCTION DEFINITIONS                       **
+**********************************************************************/
+
+// one block of Philox4x32-10
+void philox4x32(const uint32_t* counter, const uint32_t* key, uint32_t* result) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    uint64_t p0, p1;
+    unsigned round;
+
+    for (round = 0; round < 10; round++) {
+        p0 = (uint64_t) PHILOX_M0 * c0;
+        p1 = (uint64_t) PHILOX_M1 * c2;
+        c0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        c2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t) p1;
+        c3 = (uint32_t) p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    result[0] = c0;
+    result[1] = c1;
+    result[2] = c2;
+    result[3] = c3;
+}
+
+// appends moves turning the solved cube into state: the inverse of a two-phase solution (at most 20 face moves if
+// one is found in time). solution (may be NULL) gets that solution. False if state cannot be solved.
+bool getScrambleMoves(const CubeState& state, vector<int>* moves, vector<int>* solution, unsigned timeLimitMs) {
+    vector<int> found;
+    size_t i;
+
+    if (!TwoPhaseSolver::getInstance().solve(state, &found, 20, timeLimitMs))
+        return false;
+    optimizeMoves(&found);
+    for (i = found.size(); i-- > 0;)
+        moves->push_back(inverseMove(found[i]));
+    if (solution != NULL)
+        solution->insert(solution->end(), found.begin(), found.end());
+    return true;
+}
+
+// for runs that do not ask for a seed: differs from run to run, also within the same second
+uint64_t getTimeSeed() {
+    uint64_t ticks = chrono::steady_clock::now().time_since_epoch().count();
+    uint32_t input[4] = {(uint32_t) ticks, (uint32_t) (ticks >> 32), (uint32_t) time(NULL), 0};
+    uint32_t key[2] = {0, 0};
+    uint32_t result[4];
+
+    philox4x32(input, key, result);
+    return result[0] | (uint64_t) result[1] << 32;
+}
+
+// scramble i is the one of stream first + i under seed, whichever thread makes it: states[i] and, for SCRAMBLE_MOVES,
+// faceMoves[i*length ...] (either may be NULL)
+void generateScrambles(uint64_t seed, ScrambleMode mode, unsigned length, uint64_t first, size_t count,
+                       CubeState* states, uint8_t* faceMoves) {
+    size_t nrChunks = (count + SCRAMBLE_CHUNK - 1) / SCRAMBLE_CHUNK;
+
+    WorkStealingPool::getInstance().parallelFor(nrChunks, [&](size_t chunk, unsigned) {
+        Scrambler scrambler(seed);
+        size_t end = (chunk + 1) * SCRAMBLE_CHUNK < count ? (chunk + 1) * SCRAMBLE_CHUNK : count;
+        size_t i;
+
+        for (i = chunk * SCRAMBLE_CHUNK; i < end; i++) {
+            scrambler.seek(first + i);
+            if (mode == SCRAMBLE_MOVES && faceMoves != NULL) {
+                scrambler.randomFaceMoves(length, faceMoves + i * length);
+                if (states != NULL) {
+                    states[i].reset();
+                    applyFaceMoves(&states[i], faceMoves + i * length, length);
+                }
+            } else if (states != NULL) {
+                scrambler.scramble(mode, length, &states[i]);
+            }
+        }
+    });
+}
@@ -0,0 +1,61 @@
+// header file for scrambler.cc
+
+#ifndef SCRAMBLER_H
+#define SCRAMBLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "cubestate.h"
+
+using namespace std;
+
+const unsigned SCRAMBLE_LENGTH = 25;       // face moves of the scrambles of the renderer
+const unsigned SCRAMBLE_SOLVE_MS = 1000;   // time limit for the moves of random states, stops earlier at 20 moves
+const uint32_t NR_EDGE_PERMS = 479001600;  // 12!
+const uint32_t SCRAMBLER_VERSION = 1;      // raised whenever a seed and stream would give another scramble
+
+enum ScrambleMode {
+    SCRAMBLE_RANDOM_STATE,      // every solvable state equally likely
+    SCRAMBLE_MOVES              // length face moves, no two in a row on one face or in both orders on opposite faces
+};
+
+class Scrambler {
+private:
+    /***************************************************************
+    ** Philox4x32-10 (Salmon et al., Random123) as the random     **
+    ** source of the scrambles: block n of stream s under seed k  **
+    ** is ten multiply-xor rounds over the counter (n, s) keyed   **
+    ** by k. No state is shared between streams, so each thread  **
+    ** (or each scramble of a batch) gets its own stream and the  **
+    ** results never depend on how the work was split. Seeds are  **
+    ** explicit, equal seeds and streams give equal scrambles.    **
+    ***************************************************************/
+    uint32_t key[2];
+    uint64_t stream;
+    uint64_t counter;           // next block of the stream
+    uint32_t block[4];
+    unsigned used;              // words of block already handed out
+
+    void nextBlock();
+
+public:
+    Scrambler(uint64_t seed, uint64_t stream=0);
+
+    void seek(uint64_t stream, uint64_t counter=0);
+    uint32_t next();
+    unsigned nextBelow(unsigned bound);
+
+    void randomState(CubeState* state);
+    void randomFaceMoves(unsigned length, uint8_t* faceMoves);
+    void scramble(ScrambleMode mode, unsigned length, CubeState* state, vector<int>* moves=NULL);
+};
+
+void philox4x32(const uint32_t* counter, const uint32_t* key, uint32_t* result);
+bool getScrambleMoves(const CubeState& state, vector<int>* moves, vector<int>* solution=NULL,
+                      unsigned timeLimitMs=SCRAMBLE_SOLVE_MS);
+uint64_t getTimeSeed();
+void generateScrambles(uint64_t seed, ScrambleMode mode, unsigned length, uint64_t first, size_t count,
+                       CubeState* states, uint8_t* faceMoves);
+
+#endif
@@ -0,0 +1,85 @@
+/* standard includes */
+#include <stdint.h>
+#include <vector>
+#include <chrono>
+#include "scrambletask.h"
+#include "twophase.h"
+#include "moveoptimizer.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+// the scrambles of equal seeds are equal, one after the other
+ScrambleTask::ScrambleTask(uint64_t seed, ScrambleMode mode) {
+    this->seed = seed;
+    this->mode = mode;
+    nrScrambles = 0;
+    solveMilliseconds = 0;
+    stage.store(SCRAMBLE_SOLVED, memory_order_relaxed);
+}
+
+// starts the next scramble, the results of the last one are gone then. Waits for the last task if it is still
+// solving, which takes long only while the solver tables are set up.
+void ScrambleTask::start() {
+    if (solvedFuture.valid())
+        solvedFuture.wait();
+
+    stage.store(SCRAMBLE_RUNNING, memory_order_relaxed);
+    ready = promise<void>();
+    readyFuture = ready.get_future();
+    solvedFuture = async(launch::async, &ScrambleTask::run, this, nrScrambles++);
+}
+
+// SCRAMBLE_LENGTH face moves (as move codes) or a random state from the stream of seed. The moves of a random state
+// are the inverse of its solution, so it is ready only when it is solved.
+void ScrambleTask::run(uint64_t stream) {
+    Scrambler scrambler(seed, stream);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    scramble.clear();
+    solution.clear();
+    if (mode == SCRAMBLE_RANDOM_STATE) {
+        scrambler.randomState(&state);
+        getScrambleMoves(state, &scramble, &solution);
+        solveMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        stage.store(SCRAMBLE_SOLVED, memory_order_release);
+        ready.set_value();
+        return;
+    }
+
+    scrambler.scramble(SCRAMBLE_MOVES, SCRAMBLE_LENGTH, &state, &scramble);
+    stage.store(SCRAMBLE_READY, memory_order_release);
+    ready.set_value();
+
+    start = chrono::steady_clock::now();
+    TwoPhaseSolver::getInstance().solve(state, &solution, 20, SCRAMBLE_SOLVE_MS);
+    optimizeMoves(&solution);
+    solveMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    stage.store(SCRAMBLE_SOLVED, memory_order_release);
+}
+
+// move codes of the scramble, from the solved cube
+const vector<int>& ScrambleTask::getScramble() {
+    if (!isReady())
+        readyFuture.wait();
+    return scramble;
+}
+
+const CubeState& ScrambleTask::getState() {
+    if (!isReady())
+        readyFuture.wait();
+    return state;
+}
+
+// milliseconds the solve took, counted from the end of the scramble (the solver tables included the first time)
+const vector<int>& ScrambleTask::getSolution(double* milliseconds) {
+    if (!isSolved())
+        solvedFuture.wait();
+    if (milliseconds != NULL)
+        *milliseconds = solveMilliseconds;
+    return solution;
+}
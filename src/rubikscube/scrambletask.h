@@ -0,0 +1,59 @@
+// header file for scrambletask.cc
+
+#ifndef SCRAMBLETASK_H
+#define SCRAMBLETASK_H
+
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+#include <future>
+#include "cubestate.h"
+#include "scrambler.h"
+
+using namespace std;
+
+// how far the task got, in the order it gets there
+const unsigned SCRAMBLE_RUNNING = 0;
+const unsigned SCRAMBLE_READY = 1;
+const unsigned SCRAMBLE_SOLVED = 2;
+
+class ScrambleTask {
+private:
+    /***************************************************************
+    ** Makes the next scramble and its solution on a thread of    **
+    ** its own, so the window draws its first frame before any    **
+    ** cube work (or the setup of the solver tables) is done.     **
+    ** Each result is handed over through the atomic stage        **
+    ** (release on the task side, acquire on the render loop's):  **
+    ** the loop checks it without a lock and waits on a future    **
+    ** only for a result that is not there yet.                   **
+    ***************************************************************/
+    uint64_t seed;
+    ScrambleMode mode;
+    uint64_t nrScrambles;       // started so far, each one is a stream of its own
+    vector<int> scramble;
+    CubeState state;            // the solved cube after scramble
+    vector<int> solution;
+    double solveMilliseconds;
+    atomic<unsigned> stage;
+    promise<void> ready;
+    future<void> readyFuture;
+    future<void> solvedFuture;
+
+    ScrambleTask(const ScrambleTask&);
+    ScrambleTask& operator=(const ScrambleTask&);
+
+    void run(uint64_t stream);
+
+public:
+    ScrambleTask(uint64_t seed, ScrambleMode mode=SCRAMBLE_MOVES);
+
+    void start();
+    bool isReady() const { return stage.load(memory_order_acquire) >= SCRAMBLE_READY; }
+    bool isSolved() const { return stage.load(memory_order_acquire) >= SCRAMBLE_SOLVED; }
+    const vector<int>& getScramble();
+    const CubeState& getState();
+    const vector<int>& getSolution(double* milliseconds=NULL);
+};
+
+#endif
@@ -0,0 +1,168 @@
+/* standard includes */
+#include <stdint.h>
+#include "threadpool.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                          HELPER FUNCTIONS                         **
+**********************************************************************/
+
+static inline uint64_t packRange(uint32_t begin, uint32_t end) {
+    return begin | (uint64_t) end << 32;
+}
+
+static inline uint32_t rangeBegin(uint64_t range) {
+    return (uint32_t) range;
+}
+
+static inline uint32_t rangeEnd(uint64_t range) {
+    return (uint32_t) (range >> 32);
+}
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+// nrThreads workers including the calling thread, 0: one per cpu
+WorkStealingPool::WorkStealingPool(unsigned nrThreads) {
+    unsigned i;
+
+    if (nrThreads == 0)
+        nrThreads = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+    nrWorkers = nrThreads;
+    ranges.reset(new WorkRange[nrWorkers]);
+    for (i = 0; i < nrWorkers; i++)
+        ranges[i].range = 0;
+    task = NULL;
+    offset = 0;
+    generation = 0;
+    running = 0;
+    stopping = false;
+
+    for (i = 1; i < nrWorkers; i++)
+        threads.push_back(thread(&WorkStealingPool::workerLoop, this, i));
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    unsigned i;
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+void WorkStealingPool::workerLoop(unsigned worker) {
+    uint64_t seen = 0;
+
+    for (;;) {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [this, seen]() { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+        runTasks(worker);
+        {
+            lock_guard<mutex> guard(lock);
+            if (--running == 0)
+                done.notify_all();
+        }
+    }
+}
+
+void WorkStealingPool::runTasks(unsigned worker) {
+    uint32_t index;
+
+    do {
+        while (takeTask(worker, &index))
+            (*task)(offset + index, worker);
+    } while (stealTasks(worker));
+}
+
+// front of the own range
+bool WorkStealingPool::takeTask(unsigned worker, uint32_t* index) {
+    atomic<uint64_t>& range = ranges[worker].range;
+    uint64_t current = range.load(memory_order_relaxed);
+
+    while (rangeBegin(current) < rangeEnd(current)) {
+        if (range.compare_exchange_weak(current, packRange(rangeBegin(current) + 1, rangeEnd(current)), memory_order_acquire,
+                                        memory_order_relaxed)) {
+            *index = rangeBegin(current);
+            return true;
+        }
+    }
+    return false;
+}
+
+// moves the back half (at least one index) of the largest range of the other workers into the own, empty range.
+// Returns false once every range is empty, no new indices appear after that.
+bool WorkStealingPool::stealTasks(unsigned worker) {
+    uint64_t current, stolen;
+    uint32_t size, largest, middle;
+    unsigned victim, i;
+
+    for (;;) {
+        largest = 0;
+        victim = worker;
+        for (i = 0; i < nrWorkers; i++) {
+            current = ranges[i].range.load(memory_order_relaxed);
+            size = rangeEnd(current) - rangeBegin(current);
+            if (i != worker && rangeBegin(current) < rangeEnd(current) && size > largest) {
+                largest = size;
+                victim = i;
+            }
+        }
+        if (victim == worker)
+            return false;
+
+        current = ranges[victim].range.load(memory_order_relaxed);
+        if (rangeBegin(current) >= rangeEnd(current))
+            continue;
+        middle = rangeEnd(current) - (rangeEnd(current) - rangeBegin(current) + 1) / 2;
+        stolen = packRange(middle, rangeEnd(current));
+        if (ranges[victim].range.compare_exchange_strong(current, packRange(rangeBegin(current), middle), memory_order_acquire,
+                                                         memory_order_relaxed)) {
+            ranges[worker].range.store(stolen, memory_order_release);
+            return true;
+        }
+    }
+}
+
+void WorkStealingPool::parallelFor(size_t count, const function<void(size_t, unsigned)>& task) {
+    lock_guard<mutex> call(callLock);
+    size_t chunk, first;
+    unsigned i;
+
+    // ranges hold 32 bit indices
+    for (first = 0; first < count; first += chunk) {
+        chunk = count - first < UINT32_MAX ? count - first : UINT32_MAX;
+        for (i = 0; i < nrWorkers; i++)
+            ranges[i].range.store(packRange(chunk * i / nrWorkers, chunk * (i + 1) / nrWorkers), memory_order_relaxed);
+        {
+            lock_guard<mutex> guard(lock);
+            this->task = &task;
+            offset = first;
+            running = nrWorkers - 1;
+            generation++;
+        }
+        wake.notify_all();
+
+        runTasks(0);
+
+        unique_lock<mutex> guard(lock);
+        done.wait(guard, [this]() { return running == 0; });
+    }
+}
+
+// shared pool with one worker per cpu
+WorkStealingPool& WorkStealingPool::getInstance() {
+    static WorkStealingPool pool;
+    return pool;
+}
@@ -0,0 +1,67 @@
+// header file for threadpool.cc
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+using namespace std;
+
+class WorkStealingPool {
+private:
+    /***************************************************************
+    ** Fixed set of worker threads running the indices of a       **
+    ** parallelFor. Every worker starts with an equal share of    **
+    ** the indices and takes them one by one from the front of    **
+    ** its range, a worker running out steals the back half of    **
+    ** the largest range left. A range is begin | end << 32 in    **
+    ** one atomic word, so taking and stealing are a single CAS.  **
+    ** The calling thread is worker 0.                            **
+    ***************************************************************/
+    struct alignas(64) WorkRange {
+        atomic<uint64_t> range;
+    };
+
+    unique_ptr<WorkRange[]> ranges;
+    vector<thread> threads;
+    unsigned nrWorkers;
+
+    mutex callLock;                 // one parallelFor at a time
+    mutex lock;
+    condition_variable wake;
+    condition_variable done;
+    const function<void(size_t, unsigned)>* task;
+    size_t offset;
+    uint64_t generation;
+    unsigned running;
+    bool stopping;
+
+    WorkStealingPool(const WorkStealingPool&);
+    WorkStealingPool& operator=(const WorkStealingPool&);
+
+    void workerLoop(unsigned worker);
+    void runTasks(unsigned worker);
+    bool takeTask(unsigned worker, uint32_t* index);
+    bool stealTasks(unsigned worker);
+
+public:
+    WorkStealingPool(unsigned nrThreads=0);
+    ~WorkStealingPool();
+
+    unsigned getNrThreads() const { return nrWorkers; }
+
+    // calls task(index, worker) for every index below count and returns when all calls returned
+    void parallelFor(size_t count, const function<void(size_t, unsigned)>& task);
+
+    static WorkStealingPool& getInstance();
+};
+
+#endif
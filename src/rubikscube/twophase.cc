@@ -0,0 +1,242 @@
+/* standard includes */
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include <string>
+#include "twophase.h"
+#include "cubecoords.h"
+
+using namespace std;
+
+
+/**********************************************************************
+**                             CONSTANTS                             **
+**********************************************************************/
+
+const unsigned MAX_SOLUTION_LENGTH = 31;
+const unsigned MAX_PHASE2_LENGTH = 12;  // longer phase 2 searches rarely pay off, a longer phase 1 is tried instead
+
+// face moves of the subgroup: U, R2, F2, D, L2, B2
+static const uint8_t phase2Moves[NR_PHASE2_MOVES] = {0, 1, 2, 4, 7, 9, 10, 11, 13, 16};
+
+static bool isPhase2Move(unsigned faceMove) {
+    return faceMove / 3 % 3 == 0 || faceMove % 3 == 1;
+}
+
+
+/**********************************************************************
+**                      MOVE AND PRUNING TABLES                      **
+**********************************************************************/
+
+// row c holds the coordinate reached from c by every move of moveList
+template <class T>
+static void buildMoveTable(vector<T>& table, unsigned size, const uint8_t* moveList, unsigned nrMoves,
+                           unsigned (*get)(const CubeState&), void (*set)(CubeState*, unsigned)) {
+    unsigned c, m;
+    table.resize(size * nrMoves);
+    for (c = 0; c < size; c++) {
+        for (m = 0; m < nrMoves; m++) {
+            CubeState state;
+            set(&state, c);
+            applyFaceMove(&state, moveList[m]);
+            table[c*nrMoves + m] = get(state);
+        }
+    }
+}
+
+// loads the table from directory or fills it by a breadth first search over the product of two coordinates
+template <class T1, class T2>
+static void loadPruneTable(PatternTable& table, const string& directory, unsigned kind, const vector<T1>& move1, unsigned size1,
+                           const vector<T2>& move2, unsigned size2, unsigned nrMoves, unsigned start, unsigned nrThreads) {
+    if (!directory.empty() && table.load(getPatternPath(directory, kind), kind, size1 * size2, 8))
+        return;
+    table.allocate(kind, size1 * size2, 8);
+    table.build(start, nrMoves, [&](uint64_t index, uint64_t* next) {
+        unsigned m;
+        for (m = 0; m < nrMoves; m++)
+            next[m] = (uint64_t) move1[index / size2 * nrMoves + m] * size2 + move2[index % size2 * nrMoves + m];
+    }, nrThreads);
+}
+
+
+/**********************************************************************
+**                               SEARCH                              **
+**********************************************************************/
+
+struct TwoPhaseSearch {
+    const TwoPhaseSolver& solver;
+    CubeState state;
+    unsigned solvedSlice;
+    uint8_t path[MAX_SOLUTION_LENGTH + 1];
+    uint8_t bestPath[MAX_SOLUTION_LENGTH + 1];
+    unsigned bestLength;
+    unsigned targetLength;
+    chrono::steady_clock::time_point deadline;
+    unsigned long nodes;
+    bool stopped;
+
+    TwoPhaseSearch(const TwoPhaseSolver& solver, const CubeState& state, unsigned targetLength, unsigned timeLimitMs)
+        : solver(solver), state(state), solvedSlice(getSlice(CubeState())), bestLength(MAX_SOLUTION_LENGTH + 1),
+          targetLength(targetLength), deadline(chrono::steady_clock::now() + chrono::milliseconds(timeLimitMs)),
+          nodes(0), stopped(false) {}
+
+    unsigned phase1Distance(unsigned twist, unsigned flip, unsigned slice) {
+        unsigned a = solver.sliceTwistPrune.get(slice*NR_TWISTS + twist);
+        unsigned b = solver.sliceFlipPrune.get(slice*NR_FLIPS + flip);
+        return a > b ? a : b;
+    }
+
+    unsigned phase2Distance(unsigned cornerPerm, unsigned edgePerm, unsigned slicePerm) {
+        unsigned a = solver.cornerPermPrune.get(cornerPerm*NR_SLICE_PERMS + slicePerm);
+        unsigned b = solver.edgePermPrune.get(edgePerm*NR_SLICE_PERMS + slicePerm);
+        return a > b ? a : b;
+    }
+
+    // the first solution is always searched to the end, afterwards the time limit stops the search
+    void checkTime() {
+        if (bestLength <= MAX_SOLUTION_LENGTH && chrono::steady_clock::now() > deadline)
+            stopped = true;
+    }
+
+    void run() {
+        unsigned twist = getTwist(state), flip = getFlip(state), slice = getSlice(state);
+        unsigned depth;
+        for (depth = phase1Distance(twist, flip, slice); depth < bestLength && !stopped; depth++)
+            phase1(twist, flip, slice, 0, depth, NO_FACE);
+    }
+
+    void phase1(unsigned twist, unsigned flip, unsigned slice, unsigned depth, unsigned togo, unsigned lastFace) {
+        unsigned face, m, nextTwist, nextFlip, nextSlice;
+
+        if (togo == 0) {
+            // a phase 1 solution ending in a subgroup move was already tried one move shorter
+            if (depth == 0 || !isPhase2Move(path[depth - 1]))
+                startPhase2(depth);
+            return;
+        }
+        if (++nodes % 4096 == 0)
+            checkTime();
+
+        for (face = 0; face < 6 && !stopped; face++) {
+            if (isRedundantFace(face, lastFace))
+                continue;
+            for (m = 3*face; m < 3*face + 3; m++) {
+                nextTwist = solver.twistMove[twist*NR_FACE_MOVES + m];
+                nextFlip = solver.flipMove[flip*NR_FACE_MOVES + m];
+                nextSlice = solver.sliceMove[slice*NR_FACE_MOVES + m];
+                if (phase1Distance(nextTwist, nextFlip, nextSlice) >= togo)
+                    continue;
+                path[depth] = m;
+                phase1(nextTwist, nextFlip, nextSlice, depth + 1, togo - 1, face);
+            }
+        }
+    }
+
+    void startPhase2(unsigned depth1) {
+        CubeState inSubgroup = state;
+        unsigned cornerPerm, edgePerm, slicePerm, depth2, i;
+
+        for (i = 0; i < depth1; i++)
+            applyFaceMove(&inSubgroup, path[i]);
+        cornerPerm = getCornerPerm(inSubgroup);
+        edgePerm = getEdgePerm(inSubgroup);
+        slicePerm = getSlicePerm(inSubgroup);
+
+        for (depth2 = phase2Distance(cornerPerm, edgePerm, slicePerm); depth2 <= MAX_PHASE2_LENGTH && depth1 + depth2 < bestLength; depth2++) {
+            if (phase2(cornerPerm, edgePerm, slicePerm, depth1, depth2, depth1 > 0 ? path[depth1 - 1] / 3 : NO_FACE)) {
+                bestLength = depth1 + depth2;
+                memcpy(bestPath, path, bestLength);
+                if (bestLength <= targetLength)
+                    stopped = true;
+                break;
+            }
+        }
+        checkTime();
+    }
+
+    bool phase2(unsigned cornerPerm, unsigned edgePerm, unsigned slicePerm, unsigned depth, unsigned togo, unsigned lastFace) {
+        unsigned k, face, nextCornerPerm, nextEdgePerm, nextSlicePerm;
+
+        if (togo == 0)
+            return cornerPerm == 0 && edgePerm == 0 && slicePerm == 0;
+        nodes++;
+
+        for (k = 0; k < NR_PHASE2_MOVES; k++) {
+            face = phase2Moves[k] / 3;
+            if (isRedundantFace(face, lastFace))
+                continue;
+            nextCornerPerm = solver.cornerPermMove[cornerPerm*NR_PHASE2_MOVES + k];
+            nextEdgePerm = solver.edgePermMove[edgePerm*NR_PHASE2_MOVES + k];
+            nextSlicePerm = solver.slicePermMove[slicePerm*NR_PHASE2_MOVES + k];
+            if (phase2Distance(nextCornerPerm, nextEdgePerm, nextSlicePerm) >= togo)
+                continue;
+            path[depth] = phase2Moves[k];
+            if (phase2(nextCornerPerm, nextEdgePerm, nextSlicePerm, depth + 1, togo - 1, face))
+                return true;
+        }
+        return false;
+    }
+};
+
+
+/**********************************************************************
+**                      CLASS MEMBER DEFINITIONS                     **
+**********************************************************************/
+
+// builds the move tables and maps the pruning tables from the pattern files in directory, the missing ones (all for "")
+// are built with nrThreads threads (0: one per cpu). Building everything takes a few hundred milliseconds.
+TwoPhaseSolver::TwoPhaseSolver(const string& directory, unsigned nrThreads) {
+    uint8_t faceMoves[NR_FACE_MOVES];
+    unsigned m;
+
+    for (m = 0; m < NR_FACE_MOVES; m++)
+        faceMoves[m] = m;
+    buildMoveTable(twistMove, NR_TWISTS, faceMoves, NR_FACE_MOVES, getTwist, setTwist);
+    buildMoveTable(flipMove, NR_FLIPS, faceMoves, NR_FACE_MOVES, getFlip, setFlip);
+    buildMoveTable(sliceMove, NR_SLICES, faceMoves, NR_FACE_MOVES, getSlice, setSlice);
+    buildMoveTable(cornerPermMove, NR_PERMS, phase2Moves, NR_PHASE2_MOVES, getCornerPerm, setCornerPerm);
+    buildMoveTable(edgePermMove, NR_PERMS, phase2Moves, NR_PHASE2_MOVES, getEdgePerm, setEdgePerm);
+    buildMoveTable(slicePermMove, NR_SLICE_PERMS, phase2Moves, NR_PHASE2_MOVES, getSlicePerm, setSlicePerm);
+
+    unsigned solvedSlice = getSlice(CubeState());
+    loadPruneTable(sliceTwistPrune, directory, PHASE1_SLICE_TWIST, sliceMove, NR_SLICES, twistMove, NR_TWISTS,
+                   NR_FACE_MOVES, solvedSlice*NR_TWISTS, nrThreads);
+    loadPruneTable(sliceFlipPrune, directory, PHASE1_SLICE_FLIP, sliceMove, NR_SLICES, flipMove, NR_FLIPS,
+                   NR_FACE_MOVES, solvedSlice*NR_FLIPS, nrThreads);
+    loadPruneTable(cornerPermPrune, directory, PHASE2_CORNER_PERM, cornerPermMove, NR_PERMS, slicePermMove, NR_SLICE_PERMS,
+                   NR_PHASE2_MOVES, 0, nrThreads);
+    loadPruneTable(edgePermPrune, directory, PHASE2_EDGE_PERM, edgePermMove, NR_PERMS, slicePermMove, NR_SLICE_PERMS,
+                   NR_PHASE2_MOVES, 0, nrThreads);
+}
+
+bool TwoPhaseSolver::saveTables(const string& directory) const {
+    return sliceTwistPrune.save(getPatternPath(directory, PHASE1_SLICE_TWIST)) && sliceFlipPrune.save(getPatternPath(directory, PHASE1_SLICE_FLIP))
+        && cornerPermPrune.save(getPatternPath(directory, PHASE2_CORNER_PERM)) && edgePermPrune.save(getPatternPath(directory, PHASE2_EDGE_PERM));
+}
+
+// solver shared by all callers, the tables are mapped (or built) on first use
+const TwoPhaseSolver& TwoPhaseSolver::getInstance() {
+    static const TwoPhaseSolver solver(getPatternDirectory());
+    return solver;
+}
+
+// appends the move codes solving state to moves (whole cube spins first if the centers are turned), returns false if
+// state cannot be solved. The search stops at the first solution of at most targetLength face moves or when the time
+// limit is over, keeping the shortest solution found until then.
+bool TwoPhaseSolver::solve(const CubeState& state, vector<int>* moves, unsigned targetLength, unsigned timeLimitMs) const {
+    CubeState oriented = state;
+    vector<int> spins;
+    unsigned i;
+
+    if (!normalizeOrientation(&oriented, &spins) || !isSolvable(oriented))
+        return false;
+
+    TwoPhaseSearch search(*this, oriented, targetLength, timeLimitMs);
+    search.run();
+
+    moves->insert(moves->end(), spins.begin(), spins.end());
+    for (i = 0; i < search.bestLength; i++)
+        appendFaceMove(search.bestPath[i], moves);
+    return true;
+}
@@ -0,0 +1,51 @@
+// header file for twophase.cc
+
+#ifndef TWOPHASE_H
+#define TWOPHASE_H
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include "cubestate.h"
+#include "cubecoords.h"
+#include "patterndb.h"
+
+using namespace std;
+
+const int NR_PHASE2_MOVES = 10;
+
+class TwoPhaseSolver {
+private:
+    /***************************************************************
+    ** Kociemba's two-phase algorithm on CubeState. Phase 1       **
+    ** brings the cube into the subgroup <U, D, R2, L2, F2, B2>   **
+    ** (all orientations solved, the four middle layer edges in   **
+    ** the middle layer), phase 2 solves it inside the subgroup.  **
+    ** Both phases are IDA* searches on coordinates with move     **
+    ** tables and pruning tables, set up once by the constructor. **
+    ** For the face moves and coordinates see cubecoords.h.       **
+    ***************************************************************/
+    vector<uint16_t> twistMove;         // [2187][NR_FACE_MOVES]
+    vector<uint16_t> flipMove;          // [2048][NR_FACE_MOVES]
+    vector<uint16_t> sliceMove;         // [495][NR_FACE_MOVES]
+    vector<uint16_t> cornerPermMove;    // [40320][NR_PHASE2_MOVES]
+    vector<uint16_t> edgePermMove;      // [40320][NR_PHASE2_MOVES]
+    vector<uint8_t> slicePermMove;      // [24][NR_PHASE2_MOVES]
+
+    PatternTable sliceTwistPrune;       // [495][2187] moves to the subgroup
+    PatternTable sliceFlipPrune;        // [495][2048]
+    PatternTable cornerPermPrune;       // [40320][24] moves to solved within the subgroup
+    PatternTable edgePermPrune;         // [40320][24]
+
+    friend struct TwoPhaseSearch;
+
+public:
+    TwoPhaseSolver(const string& directory="", unsigned nrThreads=0);
+    bool saveTables(const string& directory) const;
+
+    bool solve(const CubeState& state, vector<int>* moves, unsigned targetLength=20, unsigned timeLimitMs=10) const;
+
+    static const TwoPhaseSolver& getInstance();
+};
+
+#endif
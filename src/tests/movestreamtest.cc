@@ -0,0 +1,126 @@
+/* standard includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "rubikscube/movestream.h"
+#include "rubikscube/rubikscube.h"
+#include "rubikscube/scrambler.h"
+
+using namespace std;
+
+/**********************************************************************
+** movestreamtest -- packs solutions of the layer solver with and    **
+** without the layer by layer dictionary, reads them back and checks **
+** that the words make the stream smaller                            **
+**                                                                   **
+** usage: movestreamtest [solutions]   (default: 200)                **
+**********************************************************************/
+
+static bool checkOrientationTable() {
+    unsigned orientation, other, move;
+
+    for (move = 0; move < (unsigned) NR_MOVES; move++) {
+        if (moveOrientationTable.moves[0][move] != move) {
+            fprintf(stderr, "orientation 0 is not the identity\n");
+            return false;
+        }
+    }
+    for (orientation = 1; orientation < NR_ORIENTATIONS; orientation++) {
+        for (other = 0; other < orientation; other++) {
+            if (memcmp(moveOrientationTable.moves[orientation], moveOrientationTable.moves[other], NR_MOVES) == 0) {
+                fprintf(stderr, "orientations %u and %u are the same\n", other, orientation);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// every record of stream decodes to the solution it was made of
+static bool checkRecords(const vector<uint8_t>& stream, const vector<vector<int> >& solutions,
+                         const MoveDictionary* dictionary) {
+    MoveStreamReader reader(stream.data(), stream.size(), dictionary);
+    MoveSequence sequence;
+    vector<int> moves;
+    size_t i;
+
+    for (i = 0; i < solutions.size(); i++) {
+        if (!reader.next(&sequence)) {
+            fprintf(stderr, "record %zu is missing\n", i);
+            return false;
+        }
+        sequence.decode(&moves);
+        if (moves != solutions[i] || sequence.getNrMoves() != solutions[i].size()) {
+            fprintf(stderr, "record %zu does not decode to its solution\n", i);
+            return false;
+        }
+    }
+    if (reader.next(&sequence) || reader.isDamaged() || reader.getOffset() != stream.size()) {
+        fprintf(stderr, "the stream does not end after the last record\n");
+        return false;
+    }
+    return true;
+}
+
+// a word turned along with the whole cube is still one word
+static bool checkTurnedWord(const MoveDictionary& dictionary) {
+    const uint8_t* sune = dictionary.getWord(1);
+    vector<int> turned;
+    vector<uint8_t> stream;
+    unsigned orientation, i;
+
+    for (orientation = 0; orientation < NR_ORIENTATIONS; orientation++) {
+        turned.clear();
+        for (i = 0; i < dictionary.getLength(1); i++)
+            turned.push_back(moveOrientationTable.moves[orientation][sune[i]]);
+        stream.clear();
+        // count byte and two symbols
+        if (encodeMoves(turned, &stream, &dictionary) != 3 || !checkRecords(stream, vector<vector<int> >(1, turned),
+                                                                             &dictionary)) {
+            fprintf(stderr, "sune in orientation %u is not packed as one word\n", orientation);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const MoveDictionary& dictionary = getLayerByLayerDictionary();
+    unsigned count = argc > 1 ? atoi(argv[1]) : 200;
+    vector<vector<int> > solutions;
+    vector<uint8_t> plain, packed;
+    size_t nrMoves = 0;
+    unsigned i;
+
+    if (!checkOrientationTable() || !checkTurnedWord(dictionary))
+        return EXIT_FAILURE;
+
+    for (i = 0; i < count; i++) {
+        Scrambler scrambler(i + 1);
+        CubeState state;
+        AlgoCube cube;
+
+        scrambler.scramble(SCRAMBLE_MOVES, SCRAMBLE_LENGTH, &state);
+        cube.setVerbose(false);
+        if (!cube.solveState(state)) {
+            fprintf(stderr, "scramble %u cannot be solved\n", i + 1);
+            return EXIT_FAILURE;
+        }
+        solutions.push_back(cube.getMoves());
+        nrMoves += solutions.back().size();
+        encodeMoves(solutions.back(), &plain);
+        encodeMoves(solutions.back(), &packed, &dictionary);
+    }
+    if (!checkRecords(plain, solutions, NULL) || !checkRecords(packed, solutions, &dictionary))
+        return EXIT_FAILURE;
+
+    printf("%u solutions, %zu moves: %zu bytes without words, %zu bytes with words (%.1f%%)\n", count, nrMoves,
+           plain.size(), packed.size(), plain.empty() ? 0 : 100.0 * packed.size() / plain.size());
+    if (count > 0 && packed.size() >= plain.size()) {
+        fprintf(stderr, "the dictionary does not make the solutions smaller\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
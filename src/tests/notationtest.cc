@@ -0,0 +1,169 @@
+/* standard includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <string>
+
+#include "rubikscube/notation.h"
+#include "rubikscube/cubestate.h"
+#include "rubikscube/scrambler.h"
+
+using namespace std;
+
+/**********************************************************************
+** notationtest -- checks parseNotation and writeNotation: round     **
+** trips of random move codes, truncated output, parsing into small  **
+** buffers and moves that must turn the cube the same way            **
+**                                                                   **
+** usage: notationtest                                               **
+**********************************************************************/
+
+static bool parse(const string& text, vector<int>* moves) {
+    moves->clear();
+    if (!parseNotation(text, moves)) {
+        fprintf(stderr, "\"%s\" does not parse\n", text.c_str());
+        return false;
+    }
+    return true;
+}
+
+// both texts turn a solved cube into the same state
+static bool checkSameTurn(const string& text, const string& other) {
+    vector<int> moves, otherMoves;
+    CubeState state, otherState;
+
+    if (!parse(text, &moves) || !parse(other, &otherMoves))
+        return false;
+    state.applyMoves(moves);
+    otherState.applyMoves(otherMoves);
+    if (!(state == otherState)) {
+        fprintf(stderr, "%s is not %s\n", text.c_str(), other.c_str());
+        return false;
+    }
+    return true;
+}
+
+// the same move codes, text does not need to turn the same way as it is written
+static bool checkSameCodes(const string& text, const string& other) {
+    vector<int> moves, otherMoves;
+
+    if (!parse(text, &moves) || !parse(other, &otherMoves))
+        return false;
+    if (moves != otherMoves) {
+        fprintf(stderr, "%s does not give the codes of %s\n", text.c_str(), other.c_str());
+        return false;
+    }
+    return true;
+}
+
+static bool checkRoundTrips() {
+    Scrambler scrambler(1);
+    vector<int> moves, parsed;
+    string text;
+    unsigned i, length;
+
+    for (i = 0; i < 1000; i++) {
+        moves.clear();
+        for (length = scrambler.nextBelow(40); length > 0; length--)
+            moves.push_back(scrambler.nextBelow(NR_MOVES));
+        text = toNotation(moves);
+        if (!parse(text, &parsed))
+            return false;
+        if (parsed != moves) {
+            fprintf(stderr, "\"%s\" does not give back its move codes\n", text.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// only whole moves are written, the length is the one of the whole notation
+static bool checkTruncation() {
+    vector<int> moves;
+    string full;
+    char text[32];
+    size_t size, length, expected, end;
+
+    if (!parse("R U2 F' M x", &moves))
+        return false;
+    full = toNotation(moves);
+    for (size = 0; size <= sizeof(text); size++) {
+        memset(text, '#', sizeof(text));
+        length = writeNotation(moves.data(), moves.size(), text, size);
+        if (length != full.size()) {
+            fprintf(stderr, "writeNotation into %zu chars gives length %zu, not %zu\n", size, length, full.size());
+            return false;
+        }
+        if (size == 0) {
+            if (text[0] != '#') {
+                fprintf(stderr, "writeNotation writes into an empty buffer\n");
+                return false;
+            }
+            continue;
+        }
+        // the longest run of whole moves that fits with the terminating zero
+        expected = 0;
+        for (end = 1; end <= full.size() && end < size; end++) {
+            if (end == full.size() || full[end] == ' ')
+                expected = end;
+        }
+        if (strlen(text) != expected || full.compare(0, expected, text) != 0) {
+            fprintf(stderr, "writeNotation into %zu chars gives \"%s\"\n", size, text);
+            return false;
+        }
+    }
+    return true;
+}
+
+// a long notation parsed into a buffer of four codes at a time (r2, the most one move gives) gives the codes of
+// one call
+static bool checkResumption() {
+    const char* text = "R U R' U' r2 F2 B' D L2 M E' S x2 y' z";
+    vector<int> expected, moves;
+    size_t length = strlen(text), offset = 0, errorOffset, nrMoves;
+    int buffer[4];
+    NotationResult result;
+
+    if (!parse(text, &expected))
+        return false;
+    do {
+        result = parseNotation(text + offset, length - offset, buffer, 4, &nrMoves, &errorOffset);
+        moves.insert(moves.end(), buffer, buffer + nrMoves);
+        if (result == NOTATION_TOO_MANY_MOVES) {
+            if (nrMoves == 0) {
+                fprintf(stderr, "no progress at offset %zu\n", offset);
+                return false;
+            }
+            offset += errorOffset;
+        }
+    } while (result == NOTATION_TOO_MANY_MOVES);
+    if (result != NOTATION_OK || moves != expected) {
+        fprintf(stderr, "parsing in parts does not give the codes of one call\n");
+        return false;
+    }
+    if (parseNotation("R Q", 3, buffer, 4, &nrMoves, &errorOffset) != NOTATION_BAD_MOVE || nrMoves != 1
+        || errorOffset != 2) {
+        fprintf(stderr, "Q is taken as a move\n");
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    if (!checkRoundTrips() || !checkTruncation() || !checkResumption())
+        return EXIT_FAILURE;
+
+    if (!checkSameTurn("x", "R M' L'") || !checkSameTurn("y", "U E' D'") || !checkSameTurn("z", "F S B'")
+        || !checkSameTurn("r", "R M'") || !checkSameTurn("l", "L M") || !checkSameTurn("u", "U E'")
+        || !checkSameTurn("d", "D E") || !checkSameTurn("f", "F S") || !checkSameTurn("b", "B S'")
+        || !checkSameTurn("R2", "R' R'") || !checkSameTurn("RUR'U'RUR'U'RUR'U'RUR'U'RUR'U'RUR'U'", ""))
+        return EXIT_FAILURE;
+
+    if (!checkSameCodes("Rw", "r") || !checkSameCodes("RUR'U'", "R U R' U'") || !checkSameCodes("R\xe2\x80\x99", "R'")
+        || !checkSameCodes("R2'", "R' R'") || !checkSameCodes(" \tR\n", "R"))
+        return EXIT_FAILURE;
+
+    printf("notation ok\n");
+    return EXIT_SUCCESS;
+}